@@ -0,0 +1,300 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+/*
+* Standalone reader for the QuickStats shared memory feed (QuickStatSettings::PublishSharedMemoryFeed).
+* Tails the ring buffer and prints the schema whenever it changes followed by every published frame.
+*
+* Build:
+*	Linux/Mac:	c++ -std=c++17 -O2 -I../../Source/QuickStats/Public QuickStatsFeedReader.cpp -o QuickStatsFeedReader
+*				(add -lrt on older glibc)
+*	Windows:	cl /std:c++17 /O2 /EHsc /I..\..\Source\QuickStats\Public QuickStatsFeedReader.cpp
+*
+* Usage:
+*	QuickStatsFeedReader [-interval=<milliseconds>] [-quiet]
+*	-quiet only prints the number of frames read and dropped every second.
+*/
+
+#include "QuickStatsFeedLayout.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
+namespace
+{
+	struct FMappedRegion
+	{
+		const QuickStatsFeed::FRegion* Region = nullptr;
+#if defined(_WIN32)
+		HANDLE Mapping = nullptr;
+#endif
+	};
+
+	bool MapRegion(FMappedRegion& OutMapping)
+	{
+#if defined(_WIN32)
+		HANDLE Mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, QuickStatsFeed::RegionName);
+		if (!Mapping)
+		{
+			return false;
+		}
+
+		void* Address = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, sizeof(QuickStatsFeed::FRegion));
+		if (!Address)
+		{
+			CloseHandle(Mapping);
+			return false;
+		}
+
+		OutMapping.Mapping = Mapping;
+		OutMapping.Region = static_cast<const QuickStatsFeed::FRegion*>(Address);
+#else
+		const std::string Name = std::string("/") + QuickStatsFeed::RegionName;
+		const int FileDescriptor = shm_open(Name.c_str(), O_RDONLY, 0);
+		if (FileDescriptor < 0)
+		{
+			return false;
+		}
+
+		void* Address = mmap(nullptr, sizeof(QuickStatsFeed::FRegion), PROT_READ, MAP_SHARED, FileDescriptor, 0);
+		close(FileDescriptor);
+		if (Address == MAP_FAILED)
+		{
+			return false;
+		}
+
+		OutMapping.Region = static_cast<const QuickStatsFeed::FRegion*>(Address);
+#endif
+		return true;
+	}
+
+	void UnmapRegion(FMappedRegion& Mapping)
+	{
+		if (!Mapping.Region)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(Mapping.Region);
+		CloseHandle(Mapping.Mapping);
+		Mapping.Mapping = nullptr;
+#else
+		munmap(const_cast<QuickStatsFeed::FRegion*>(Mapping.Region), sizeof(QuickStatsFeed::FRegion));
+#endif
+		Mapping.Region = nullptr;
+	}
+
+	struct FStatInfo
+	{
+		std::string PresetName;
+		std::string StatDescription;
+		double Budget = 0.;
+	};
+
+	// returns false if the writer was updating the schema, caller should retry
+	bool ReadSchema(const QuickStatsFeed::FSchema& Schema, uint64_t& OutSequence, std::vector<FStatInfo>& OutStats)
+	{
+		const uint64_t Sequence = Schema.Sequence.load(std::memory_order_acquire);
+		if (Sequence & 1)
+		{
+			return false;
+		}
+
+		const uint32_t NumStats = Schema.NumStats < QuickStatsFeed::MaxStats ? Schema.NumStats : QuickStatsFeed::MaxStats;
+		OutStats.resize(NumStats);
+		for (uint32_t StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+		{
+			const QuickStatsFeed::FStatSchema& StatSchema = Schema.Stats[StatIndex];
+			OutStats[StatIndex].PresetName.assign(StatSchema.PresetName, strnlen(StatSchema.PresetName, QuickStatsFeed::MaxNameLength));
+			OutStats[StatIndex].StatDescription.assign(StatSchema.StatDescription, strnlen(StatSchema.StatDescription, QuickStatsFeed::MaxNameLength));
+			OutStats[StatIndex].Budget = StatSchema.Budget;
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		OutSequence = Sequence;
+		return Schema.Sequence.load(std::memory_order_relaxed) == Sequence;
+	}
+
+	void PrintSchema(const std::vector<FStatInfo>& Stats)
+	{
+		printf("--- schema: %u stats\n", static_cast<uint32_t>(Stats.size()));
+		for (size_t StatIndex = 0; StatIndex < Stats.size(); ++StatIndex)
+		{
+			const FStatInfo& Stat = Stats[StatIndex];
+			printf("  [%u] %s/%s budget=%.2f\n", static_cast<uint32_t>(StatIndex), Stat.PresetName.c_str(), Stat.StatDescription.c_str(), Stat.Budget);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int IntervalMs = 5;
+	bool bQuiet = false;
+	for (int ArgIndex = 1; ArgIndex < argc; ++ArgIndex)
+	{
+		if (strncmp(argv[ArgIndex], "-interval=", 10) == 0)
+		{
+			IntervalMs = atoi(argv[ArgIndex] + 10);
+		}
+		else if (strcmp(argv[ArgIndex], "-quiet") == 0)
+		{
+			bQuiet = true;
+		}
+	}
+
+	FMappedRegion Mapping;
+	uint64_t NextFrameIndex = 0;
+	uint64_t SchemaSequence = 0;
+	bool bHasSchema = false;
+	std::vector<FStatInfo> Stats;
+
+	uint64_t NumFramesRead = 0;
+	uint64_t NumFramesDropped = 0;
+	auto LastReportTime = std::chrono::steady_clock::now();
+
+	printf("Waiting for QuickStats feed(%s)...\n", QuickStatsFeed::RegionName);
+
+	for (;;)
+	{
+		if (!Mapping.Region)
+		{
+			if (!MapRegion(Mapping))
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(500));
+				continue;
+			}
+			NextFrameIndex = 0;
+			bHasSchema = false;
+		}
+
+		const QuickStatsFeed::FRegion& Region = *Mapping.Region;
+		if (Region.Header.Magic.load(std::memory_order_acquire) != QuickStatsFeed::Magic || Region.Header.Version != QuickStatsFeed::Version)
+		{
+			// writer is not initialized yet or shut down, remap to pick up a new writer
+			UnmapRegion(Mapping);
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+			continue;
+		}
+
+		const uint64_t NumFramesWritten = Region.Header.NumFramesWritten.load(std::memory_order_acquire);
+		if (NumFramesWritten < NextFrameIndex)
+		{
+			// writer restarted, its schema sequence starts over
+			NextFrameIndex = 0;
+			bHasSchema = false;
+		}
+		if (NumFramesWritten - NextFrameIndex > QuickStatsFeed::MaxFrames)
+		{
+			// writer lapped the reader, skip to the oldest frame still in the ring
+			NumFramesDropped += NumFramesWritten - QuickStatsFeed::MaxFrames - NextFrameIndex;
+			NextFrameIndex = NumFramesWritten - QuickStatsFeed::MaxFrames;
+		}
+
+		while (NextFrameIndex < NumFramesWritten)
+		{
+			const QuickStatsFeed::FFrame& Frame = Region.Frames[NextFrameIndex % QuickStatsFeed::MaxFrames];
+
+			const uint64_t Sequence = Frame.Sequence.load(std::memory_order_acquire);
+			if (Sequence & 1)
+			{
+				// being written, only happens if the writer lapped us
+				break;
+			}
+
+			const uint64_t FrameSchemaSequence = Frame.SchemaSequence;
+			if (!bHasSchema || FrameSchemaSequence > SchemaSequence)
+			{
+				uint64_t NewSchemaSequence = 0;
+				if (!ReadSchema(Region.Schema, NewSchemaSequence, Stats))
+				{
+					break;
+				}
+				SchemaSequence = NewSchemaSequence;
+				bHasSchema = true;
+				if (!bQuiet)
+				{
+					PrintSchema(Stats);
+				}
+			}
+
+			if (FrameSchemaSequence < SchemaSequence)
+			{
+				// written with a schema the writer already replaced, its stats can't be named anymore
+				++NumFramesDropped;
+				++NextFrameIndex;
+				continue;
+			}
+			if (FrameSchemaSequence != SchemaSequence)
+			{
+				// schema changed again while it was read, retry on the next poll
+				break;
+			}
+
+			// values are read in place, the sequence check below discards them if the slot was overwritten meanwhile
+			std::string Line;
+			if (!bQuiet)
+			{
+				char Buffer[128];
+				snprintf(Buffer, sizeof(Buffer), "frame %llu t=%.3f", static_cast<unsigned long long>(Frame.FrameNumber), Frame.Time);
+				Line = Buffer;
+
+				const uint32_t NumValues = Frame.NumValues < Stats.size() ? Frame.NumValues : static_cast<uint32_t>(Stats.size());
+				for (uint32_t ValueIndex = 0; ValueIndex < NumValues; ++ValueIndex)
+				{
+					const double Value = Frame.Values[ValueIndex];
+					if (std::isnan(Value))
+					{
+						snprintf(Buffer, sizeof(Buffer), " | %s=N/A", Stats[ValueIndex].StatDescription.c_str());
+					}
+					else
+					{
+						snprintf(Buffer, sizeof(Buffer), " | %s=%.2f", Stats[ValueIndex].StatDescription.c_str(), Value);
+					}
+					Line += Buffer;
+				}
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Frame.Sequence.load(std::memory_order_relaxed) != Sequence || Frame.SchemaSequence != SchemaSequence)
+			{
+				// torn read, the outer loop handles the lap
+				break;
+			}
+
+			if (!bQuiet)
+			{
+				printf("%s\n", Line.c_str());
+			}
+
+			++NumFramesRead;
+			++NextFrameIndex;
+		}
+
+		const auto CurrentTime = std::chrono::steady_clock::now();
+		if (bQuiet && CurrentTime - LastReportTime >= std::chrono::seconds(1))
+		{
+			printf("read %llu frames, dropped %llu\n", static_cast<unsigned long long>(NumFramesRead), static_cast<unsigned long long>(NumFramesDropped));
+			LastReportTime = CurrentTime;
+		}
+		fflush(stdout);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(IntervalMs));
+	}
+
+	return 0;
+}
@@ -0,0 +1,342 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+/*
+* Standalone client for the QuickStats stats stream (QuickStatSettings::StreamStats).
+* Decodes the stream, checks that frame numbers are contiguous and reports throughput every second.
+*
+* Build:
+*	Linux/Mac:	c++ -std=c++17 -O2 -I../../Source/QuickStats/Public QuickStatsStreamClient.cpp -o QuickStatsStreamClient
+*	Windows:	cl /std:c++17 /O2 /EHsc /I..\..\Source\QuickStats\Public QuickStatsStreamClient.cpp ws2_32.lib
+*
+* Usage:
+*	QuickStatsStreamClient [-host=127.0.0.1] [-port=7272] [-print]
+*	-print prints decoded values of every frame.
+*/
+
+#include "QuickStatsStreamProtocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	using FSocketHandle = SOCKET;
+	static const FSocketHandle InvalidSocket = INVALID_SOCKET;
+	static void CloseSocket(FSocketHandle Socket) { closesocket(Socket); }
+#else
+	#include <arpa/inet.h>
+	#include <netinet/in.h>
+	#include <sys/socket.h>
+	#include <unistd.h>
+	using FSocketHandle = int;
+	static const FSocketHandle InvalidSocket = -1;
+	static void CloseSocket(FSocketHandle Socket) { close(Socket); }
+#endif
+
+namespace
+{
+	struct FStatInfo
+	{
+		std::string PresetName;
+		std::string StatDescription;
+		double Budget = 0.;
+	};
+
+	struct FStreamState
+	{
+		uint32_t SchemaId = 0;
+		std::vector<FStatInfo> Stats;
+		std::vector<uint64_t> ValueBits;
+		uint64_t FrameNumber = 0;
+		uint64_t TimeMicroseconds = 0;
+		bool bHasFrame = false;
+
+		uint64_t NumFrames = 0;
+		uint64_t NumPackets = 0;
+		uint64_t NumBytes = 0;
+		// frames missing between consecutive frame numbers, game didn't evaluate stats or the stream lost them
+		uint64_t NumFrameGaps = 0;
+	};
+
+	template<typename T>
+	bool ReadPOD(const uint8_t*& Src, const uint8_t* End, T& OutValue)
+	{
+		if (End - Src < (std::ptrdiff_t)sizeof(T))
+		{
+			return false;
+		}
+		memcpy(&OutValue, Src, sizeof(T));
+		Src += sizeof(T);
+		return true;
+	}
+
+	bool ReadShortString(const uint8_t*& Src, const uint8_t* End, std::string& OutString)
+	{
+		uint8_t Length = 0;
+		if (!ReadPOD(Src, End, Length) || End - Src < Length)
+		{
+			return false;
+		}
+		OutString.assign(reinterpret_cast<const char*>(Src), Length);
+		Src += Length;
+		return true;
+	}
+
+	bool ReadSchema(const uint8_t* Src, const uint8_t* End, FStreamState& State)
+	{
+		uint16_t NumStats = 0;
+		if (!ReadPOD(Src, End, State.SchemaId) || !ReadPOD(Src, End, NumStats))
+		{
+			return false;
+		}
+
+		State.Stats.resize(NumStats);
+		for (FStatInfo& Stat : State.Stats)
+		{
+			if (!ReadPOD(Src, End, Stat.Budget) || !ReadShortString(Src, End, Stat.PresetName) || !ReadShortString(Src, End, Stat.StatDescription))
+			{
+				return false;
+			}
+		}
+		State.ValueBits.assign(NumStats, 0);
+
+		printf("--- schema %u: %u stats\n", State.SchemaId, NumStats);
+		for (size_t StatIndex = 0; StatIndex < State.Stats.size(); ++StatIndex)
+		{
+			const FStatInfo& Stat = State.Stats[StatIndex];
+			printf("  [%u] %s/%s budget=%.2f\n", static_cast<uint32_t>(StatIndex), Stat.PresetName.c_str(), Stat.StatDescription.c_str(), Stat.Budget);
+		}
+		return true;
+	}
+
+	bool ReadValues(const uint8_t* Src, const uint8_t* End, FStreamState& State, bool bPrint)
+	{
+		uint32_t SchemaId = 0;
+		uint8_t Flags = 0;
+		uint16_t NumFrames = 0;
+		if (!ReadPOD(Src, End, SchemaId) || !ReadPOD(Src, End, Flags) || !ReadPOD(Src, End, NumFrames))
+		{
+			return false;
+		}
+		if (SchemaId != State.SchemaId)
+		{
+			fprintf(stderr, "values for unknown schema %u\n", SchemaId);
+			return false;
+		}
+
+		const size_t NumStats = State.Stats.size();
+		uint64_t PreviousFrameNumber = State.FrameNumber;
+		uint64_t PreviousTimeMicroseconds = State.TimeMicroseconds;
+		if (Flags & QuickStatsStream::KeyFrame)
+		{
+			std::fill(State.ValueBits.begin(), State.ValueBits.end(), 0);
+			PreviousFrameNumber = 0;
+			PreviousTimeMicroseconds = 0;
+		}
+
+		for (uint16_t FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+		{
+			uint64_t FrameDelta = 0;
+			uint64_t TimeDelta = 0;
+			if (!(Src = QuickStatsStream::ReadVarint(Src, End, FrameDelta)) || !(Src = QuickStatsStream::ReadVarint(Src, End, TimeDelta)))
+			{
+				return false;
+			}
+
+			const uint64_t FrameNumber = PreviousFrameNumber + FrameDelta;
+			if (State.bHasFrame && FrameNumber > State.FrameNumber + 1)
+			{
+				State.NumFrameGaps += FrameNumber - State.FrameNumber - 1;
+			}
+			State.FrameNumber = PreviousFrameNumber = FrameNumber;
+			State.TimeMicroseconds = PreviousTimeMicroseconds = PreviousTimeMicroseconds + TimeDelta;
+			State.bHasFrame = true;
+
+			const size_t NumMaskBytes = (NumStats + 7) / 8;
+			if ((size_t)(End - Src) < NumMaskBytes)
+			{
+				return false;
+			}
+			const uint8_t* ChangedMask = Src;
+			Src += NumMaskBytes;
+
+			for (size_t StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+			{
+				if (ChangedMask[StatIndex / 8] & (1 << (StatIndex % 8)))
+				{
+					uint8_t TrailingZeros = 0;
+					uint64_t ChangedBits = 0;
+					if (!ReadPOD(Src, End, TrailingZeros) || !(Src = QuickStatsStream::ReadVarint(Src, End, ChangedBits)) || TrailingZeros > 63)
+					{
+						return false;
+					}
+					State.ValueBits[StatIndex] ^= ChangedBits << TrailingZeros;
+				}
+			}
+
+			if (bPrint)
+			{
+				printf("frame %llu t=%.3f", static_cast<unsigned long long>(FrameNumber), State.TimeMicroseconds / 1000000.);
+				for (size_t StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+				{
+					double Value;
+					memcpy(&Value, &State.ValueBits[StatIndex], sizeof(Value));
+					if (std::isnan(Value))
+					{
+						printf(" | %s=N/A", State.Stats[StatIndex].StatDescription.c_str());
+					}
+					else
+					{
+						printf(" | %s=%.2f", State.Stats[StatIndex].StatDescription.c_str(), Value);
+					}
+				}
+				printf("\n");
+			}
+
+			State.NumFrames++;
+		}
+
+		State.NumPackets++;
+		return Src == End;
+	}
+
+	bool ReceiveAll(FSocketHandle Socket, uint8_t* Dest, size_t Size)
+	{
+		while (Size > 0)
+		{
+			const int BytesRead = recv(Socket, reinterpret_cast<char*>(Dest), static_cast<int>(Size), 0);
+			if (BytesRead <= 0)
+			{
+				return false;
+			}
+			Dest += BytesRead;
+			Size -= BytesRead;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string Host = "127.0.0.1";
+	int Port = QuickStatsStream::DefaultPort;
+	bool bPrint = false;
+	for (int ArgIndex = 1; ArgIndex < argc; ++ArgIndex)
+	{
+		if (strncmp(argv[ArgIndex], "-host=", 6) == 0)
+		{
+			Host = argv[ArgIndex] + 6;
+		}
+		else if (strncmp(argv[ArgIndex], "-port=", 6) == 0)
+		{
+			Port = atoi(argv[ArgIndex] + 6);
+		}
+		else if (strcmp(argv[ArgIndex], "-print") == 0)
+		{
+			bPrint = true;
+		}
+	}
+
+#if defined(_WIN32)
+	WSADATA WsaData;
+	WSAStartup(MAKEWORD(2, 2), &WsaData);
+#endif
+
+	FSocketHandle Socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	sockaddr_in Address = {};
+	Address.sin_family = AF_INET;
+	Address.sin_port = htons(static_cast<uint16_t>(Port));
+	if (Socket == InvalidSocket || inet_pton(AF_INET, Host.c_str(), &Address.sin_addr) != 1 || connect(Socket, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0)
+	{
+		fprintf(stderr, "failed to connect to %s:%d\n", Host.c_str(), Port);
+		return 1;
+	}
+	printf("connected to %s:%d\n", Host.c_str(), Port);
+
+	FStreamState State;
+	std::vector<uint8_t> Payload;
+	auto LastReportTime = std::chrono::steady_clock::now();
+	uint64_t LastReportFrames = 0;
+	uint64_t LastReportBytes = 0;
+
+	for (;;)
+	{
+		uint8_t Header[QuickStatsStream::MessageHeaderSize];
+		if (!ReceiveAll(Socket, Header, sizeof(Header)))
+		{
+			break;
+		}
+
+		uint32_t PayloadSize = 0;
+		memcpy(&PayloadSize, Header, sizeof(PayloadSize));
+		const QuickStatsStream::EMessageType MessageType = static_cast<QuickStatsStream::EMessageType>(Header[4]);
+
+		Payload.resize(PayloadSize);
+		if (!ReceiveAll(Socket, Payload.data(), PayloadSize))
+		{
+			break;
+		}
+		State.NumBytes += sizeof(Header) + PayloadSize;
+
+		const uint8_t* Src = Payload.data();
+		const uint8_t* End = Src + PayloadSize;
+		bool bValid = true;
+		switch (MessageType)
+		{
+		case QuickStatsStream::EMessageType::Hello:
+		{
+			uint32_t Version = 0;
+			bValid = ReadPOD(Src, End, Version) && Version == QuickStatsStream::ProtocolVersion;
+			break;
+		}
+		case QuickStatsStream::EMessageType::Schema:
+			bValid = ReadSchema(Src, End, State);
+			break;
+		case QuickStatsStream::EMessageType::Values:
+			bValid = ReadValues(Src, End, State, bPrint);
+			break;
+		default:
+			// unknown messages are skipped
+			break;
+		}
+
+		if (!bValid)
+		{
+			fprintf(stderr, "malformed message (type %u, %u bytes)\n", static_cast<uint32_t>(MessageType), PayloadSize);
+			break;
+		}
+
+		const auto CurrentTime = std::chrono::steady_clock::now();
+		const double ElapsedSeconds = std::chrono::duration<double>(CurrentTime - LastReportTime).count();
+		if (!bPrint && ElapsedSeconds >= 1.)
+		{
+			const uint64_t Frames = State.NumFrames - LastReportFrames;
+			const uint64_t Bytes = State.NumBytes - LastReportBytes;
+			printf("%.1f frames/s, %.1f KB/s, %.1f bytes/frame, %llu packets, %llu frames total, %llu frame gaps\n",
+				Frames / ElapsedSeconds, Bytes / ElapsedSeconds / 1024., Frames > 0 ? double(Bytes) / Frames : 0.,
+				static_cast<unsigned long long>(State.NumPackets), static_cast<unsigned long long>(State.NumFrames), static_cast<unsigned long long>(State.NumFrameGaps));
+			fflush(stdout);
+
+			LastReportTime = CurrentTime;
+			LastReportFrames = State.NumFrames;
+			LastReportBytes = State.NumBytes;
+		}
+	}
+
+	printf("disconnected, %llu frames received, %llu frame gaps\n", static_cast<unsigned long long>(State.NumFrames), static_cast<unsigned long long>(State.NumFrameGaps));
+	CloseSocket(Socket);
+
+#if defined(_WIN32)
+	WSACleanup();
+#endif
+	return 0;
+}
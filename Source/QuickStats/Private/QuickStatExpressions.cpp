@@ -1,28 +1,112 @@
 // Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
 
 #include "QuickStatExpressions.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "RenderCore.h"
+#include "RHI.h"
 
-bool UQuickStatExpressionReadStat::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
+FString FQuickStatUnits::FormatValue(double Value, EQuickStatUnit Unit)
+{
+	if (Unit == EQuickStatUnit::Milliseconds)
+	{
+		if (FMath::Abs(Value) < 1.)
+		{
+			return FString::Printf(TEXT("%0.1f \u00B5s"), Value * 1000.);
+		}
+		return FString::Printf(TEXT("%0.2f ms"), Value);
+	}
+	else if (Unit == EQuickStatUnit::Bytes)
+	{
+		static const TCHAR* Suffixes[] = { TEXT("B"), TEXT("KB"), TEXT("MB"), TEXT("GB") };
+
+		static constexpr int32 NumSuffixes = UE_ARRAY_COUNT(Suffixes);
+
+		int32 SuffixIndex = 0;
+		while (FMath::Abs(Value) >= 1024. && SuffixIndex < NumSuffixes - 1)
+		{
+			Value /= 1024.;
+			SuffixIndex++;
+		}
+		return (SuffixIndex == 0) ? FString::Printf(TEXT("%0.0f B"), Value) : FString::Printf(TEXT("%0.2f %s"), Value, Suffixes[SuffixIndex]);
+	}
+	else if (Unit == EQuickStatUnit::Percent)
+	{
+		return FString::Printf(TEXT("%0.2f%%"), Value);
+	}
+
+	return FString::Printf(TEXT("%0.2f"), Value);
+}
+
+static EQuickStatUnit GetMultiplyUnit(EQuickStatUnit UnitA, EQuickStatUnit UnitB)
+{
+	// scaling a value keeps its unit (bytes * count), anything else is a plain number
+	if (UnitA == EQuickStatUnit::Count)
+	{
+		return UnitB;
+	}
+	return (UnitB == EQuickStatUnit::Count) ? UnitA : EQuickStatUnit::Count;
+}
+
+static EQuickStatUnit GetDivideUnit(EQuickStatUnit UnitA, EQuickStatUnit UnitB)
+{
+	// dividing by a count keeps the unit (bytes / count), ratios are plain numbers
+	return (UnitB == EQuickStatUnit::Count) ? UnitA : EQuickStatUnit::Count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UQuickStatExpressionReadStat::ReadStatValue(const FQuickStatEvaluationContext& Context, FName StatName, double& OutValue)
 {
 #if STATS
-	if (const FComplexStatMessage* StatMessage = Context.Stats.FindRef(StatDefinition.StatName))
+	if (const FComplexStatMessage* StatMessage = Context.Stats.FindRef(StatName))
 	{
-		OutResult = FPlatformTime::ToMilliseconds(StatMessage->GetValue_Duration(EComplexStatField::IncAve));
+		OutValue = FPlatformTime::ToMilliseconds(StatMessage->GetValue_Duration(EComplexStatField::IncAve));
 		return true;
 	}
-	else if (const FComplexStatMessage* CounterStatMessage = Context.CounterStats.FindRef(StatDefinition.StatName))
+	else if (const FComplexStatMessage* CounterStatMessage = Context.CounterStats.FindRef(StatName))
 	{
 		if (CounterStatMessage->NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_double)
 		{
-			OutResult = CounterStatMessage->GetValue_double(EComplexStatField::IncAve);
+			OutValue = CounterStatMessage->GetValue_double(EComplexStatField::IncAve);
 			return true;
 		}
 		else if (CounterStatMessage->NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_int64)
 		{
-			OutResult = CounterStatMessage->GetValue_int64(EComplexStatField::IncAve);
+			OutValue = CounterStatMessage->GetValue_int64(EComplexStatField::IncAve);
 			return true;
 		}
 	}
+#endif // #if STATS
+
+	return false;
+}
+
+EQuickStatUnit UQuickStatExpressionReadStat::ReadStatUnit(const FQuickStatEvaluationContext& Context, FName StatName)
+{
+#if STATS
+	if (Context.Stats.Contains(StatName))
+	{
+		return EQuickStatUnit::Milliseconds;
+	}
+	else if (const FComplexStatMessage* CounterStatMessage = Context.CounterStats.FindRef(StatName))
+	{
+		if (CounterStatMessage->NameAndInfo.GetFlag(EStatMetaFlags::IsMemory))
+		{
+			return EQuickStatUnit::Bytes;
+		}
+	}
+#endif // #if STATS
+
+	return EQuickStatUnit::Count;
+}
+
+bool UQuickStatExpressionReadStat::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
+{
+	if (ReadStatValue(Context, StatDefinition.StatName, OutResult))
+	{
+		return true;
+	}
 
 	// some stat are not always available (occluded primitives can be zero for example)
 	if (DefaultValue >= 0.)
@@ -30,7 +114,6 @@ bool UQuickStatExpressionReadStat::Evaluate(const FQuickStatEvaluationContext& C
 		OutResult = DefaultValue;
 		return true;
 	}
-#endif // #if STATS
 
 	return false;
 }
@@ -55,6 +138,32 @@ TSet<FName> UQuickStatExpressionAdd::GetRequiredStatGroupNames() const
 	return GroupNames;
 }
 
+TSet<FName> UQuickStatExpressionAdd::GetRequiredStatNames() const
+{
+	TSet<FName> StatNames;
+	for (UQuickStatExpression* Input : Inputs)
+	{
+		if (Input)
+		{
+			StatNames.Append(Input->GetRequiredStatNames());
+		}
+	}
+	return StatNames;
+}
+
+EQuickStatUnit UQuickStatExpressionAdd::GetUnit(const FQuickStatEvaluationContext& Context) const
+{
+	// inputs are expected to have the same unit
+	for (UQuickStatExpression* Input : Inputs)
+	{
+		if (Input)
+		{
+			return Input->GetUnit(Context);
+		}
+	}
+	return EQuickStatUnit::Count;
+}
+
 bool UQuickStatExpressionAdd::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
 {
 	OutResult = 0.;
@@ -87,6 +196,22 @@ TSet<FName> UQuickStatExpressionSubtract::GetRequiredStatGroupNames() const
 	return GroupNames;
 }
 
+TSet<FName> UQuickStatExpressionSubtract::GetRequiredStatNames() const
+{
+	TSet<FName> StatNames;
+	if (InputA && InputB)
+	{
+		StatNames.Append(InputA->GetRequiredStatNames());
+		StatNames.Append(InputB->GetRequiredStatNames());
+	}
+	return StatNames;
+}
+
+EQuickStatUnit UQuickStatExpressionSubtract::GetUnit(const FQuickStatEvaluationContext& Context) const
+{
+	return InputA ? InputA->GetUnit(Context) : EQuickStatUnit::Count;
+}
+
 bool UQuickStatExpressionSubtract::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
 {
 	if (InputA && InputB)
@@ -121,6 +246,32 @@ TSet<FName> UQuickStatExpressionMultiply::GetRequiredStatGroupNames() const
 	return GroupNames;
 }
 
+TSet<FName> UQuickStatExpressionMultiply::GetRequiredStatNames() const
+{
+	TSet<FName> StatNames;
+	for (UQuickStatExpression* Input : Inputs)
+	{
+		if (Input)
+		{
+			StatNames.Append(Input->GetRequiredStatNames());
+		}
+	}
+	return StatNames;
+}
+
+EQuickStatUnit UQuickStatExpressionMultiply::GetUnit(const FQuickStatEvaluationContext& Context) const
+{
+	EQuickStatUnit Unit = EQuickStatUnit::Count;
+	for (UQuickStatExpression* Input : Inputs)
+	{
+		if (Input)
+		{
+			Unit = GetMultiplyUnit(Unit, Input->GetUnit(Context));
+		}
+	}
+	return Unit;
+}
+
 bool UQuickStatExpressionMultiply::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
 {
 	OutResult = 1.;
@@ -153,6 +304,26 @@ TSet<FName> UQuickStatExpressionDivide::GetRequiredStatGroupNames() const
 	return GroupNames;
 }
 
+TSet<FName> UQuickStatExpressionDivide::GetRequiredStatNames() const
+{
+	TSet<FName> StatNames;
+	if (InputA && InputB)
+	{
+		StatNames.Append(InputA->GetRequiredStatNames());
+		StatNames.Append(InputB->GetRequiredStatNames());
+	}
+	return StatNames;
+}
+
+EQuickStatUnit UQuickStatExpressionDivide::GetUnit(const FQuickStatEvaluationContext& Context) const
+{
+	if (InputA && InputB)
+	{
+		return GetDivideUnit(InputA->GetUnit(Context), InputB->GetUnit(Context));
+	}
+	return EQuickStatUnit::Count;
+}
+
 bool UQuickStatExpressionDivide::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
 {
 	if (InputA && InputB)
@@ -171,3 +342,75 @@ bool UQuickStatExpressionDivide::Evaluate(const FQuickStatEvaluationContext& Con
 	}
 	return false;
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool UQuickStatExpressionPlatformMemory::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
+{
+	// GetStats can be expensive (reads /proc on some platforms), sample it once per frame for all the expressions
+	static uint64 SampledFrameNumber = MAX_uint64;
+	static FPlatformMemoryStats MemoryStats;
+	if (SampledFrameNumber != GFrameCounter)
+	{
+		MemoryStats = FPlatformMemory::GetStats();
+		SampledFrameNumber = GFrameCounter;
+	}
+
+	switch (MemoryStat)
+	{
+	case EQuickStatPlatformMemoryStat::UsedPhysical:		OutResult = MemoryStats.UsedPhysical; break;
+	case EQuickStatPlatformMemoryStat::PeakUsedPhysical:	OutResult = MemoryStats.PeakUsedPhysical; break;
+	case EQuickStatPlatformMemoryStat::AvailablePhysical:	OutResult = MemoryStats.AvailablePhysical; break;
+	case EQuickStatPlatformMemoryStat::UsedVirtual:			OutResult = MemoryStats.UsedVirtual; break;
+	case EQuickStatPlatformMemoryStat::PeakUsedVirtual:		OutResult = MemoryStats.PeakUsedVirtual; break;
+	case EQuickStatPlatformMemoryStat::AvailableVirtual:	OutResult = MemoryStats.AvailableVirtual; break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+EQuickStatUnit UQuickStatExpressionEngineStat::GetUnit(const FQuickStatEvaluationContext& Context) const
+{
+	return (EngineStat == EQuickStatEngineStat::DrawCalls || EngineStat == EQuickStatEngineStat::PrimitivesDrawn) ? EQuickStatUnit::Count : EQuickStatUnit::Milliseconds;
+}
+
+bool UQuickStatExpressionEngineStat::Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const
+{
+	const FQuickStatEngineSnapshot Snapshot = Context.EngineSnapshot ? *Context.EngineSnapshot : FQuickStatEngineSnapshot::Capture();
+	if (!Snapshot.bIsValid)
+	{
+		return false;
+	}
+
+	switch (EngineStat)
+	{
+	case EQuickStatEngineStat::FrameTime:			OutResult = Snapshot.FrameTime; break;
+	case EQuickStatEngineStat::GameThreadTime:		OutResult = Snapshot.GameThreadTime; break;
+	case EQuickStatEngineStat::RenderThreadTime:	OutResult = Snapshot.RenderThreadTime; break;
+	case EQuickStatEngineStat::RHIThreadTime:		OutResult = Snapshot.RHIThreadTime; break;
+	case EQuickStatEngineStat::GPUTime:				OutResult = Snapshot.GPUTime; break;
+	case EQuickStatEngineStat::DrawCalls:			OutResult = Snapshot.DrawCalls; break;
+	case EQuickStatEngineStat::PrimitivesDrawn:		OutResult = Snapshot.PrimitivesDrawn; break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+FQuickStatEngineSnapshot FQuickStatEngineSnapshot::Capture()
+{
+	// thread times and RHI counters are updated every frame regardless of stats, they hold values of the last completed frame
+	FQuickStatEngineSnapshot Snapshot;
+	Snapshot.bIsValid = true;
+	Snapshot.FrameTime = FApp::GetDeltaTime() * 1000.;
+	Snapshot.GameThreadTime = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Snapshot.RenderThreadTime = FPlatformTime::ToMilliseconds(GRenderThreadTime);
+	Snapshot.RHIThreadTime = FPlatformTime::ToMilliseconds(GRHIThreadTime);
+	Snapshot.GPUTime = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles(0));
+	Snapshot.DrawCalls = GNumDrawCallsRHI[0];
+	Snapshot.PrimitivesDrawn = GNumPrimitivesDrawnRHI[0];
+	return Snapshot;
+}
@@ -0,0 +1,77 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsAnomalyDetector.h"
+
+// deviations smaller than this (in standard deviations) don't accumulate in the CUSUM sums
+static constexpr double ChangePointDrift = 0.5;
+// counters like draw calls are often constant, deviation is kept above 1% of the mean so small jitter isn't flagged
+static constexpr double MinRelativeDeviation = 0.01;
+static constexpr double MinDeviation = 1e-6;
+
+FQuickStatsAnomalyDetector::FQuickStatsAnomalyDetector(int32 WindowSize, double InZScoreThreshold, double InChangePointThreshold)
+	: Alpha(2. / (FMath::Max(WindowSize, 1) + 1))
+	, NumWarmupValues(FMath::Max(WindowSize, 1))
+	, ZScoreThreshold(InZScoreThreshold)
+	, ChangePointThreshold(InChangePointThreshold)
+{
+}
+
+double FQuickStatsAnomalyDetector::GetDeviation() const
+{
+	return FMath::Max(FMath::Sqrt(Variance), FMath::Max(FMath::Abs(Mean) * MinRelativeDeviation, MinDeviation));
+}
+
+EQuickStatsAnomaly FQuickStatsAnomalyDetector::Add(double Value)
+{
+	if (FMath::IsNaN(Value))
+	{
+		return EQuickStatsAnomaly::None;
+	}
+
+	NumValues++;
+	NumValuesAtLevel++;
+
+	// during warmup the weights shrink like a plain average, so the first values don't dominate
+	if (NumValues <= NumWarmupValues)
+	{
+		const double Weight = FMath::Max(1. / NumValues, Alpha);
+		const double Delta = Value - Mean;
+		Mean += Weight * Delta;
+		Variance = (1. - Weight) * (Variance + Weight * Delta * Delta);
+		Score = 0.;
+		return EQuickStatsAnomaly::None;
+	}
+
+	const double Deviation = GetDeviation();
+	Score = (Value - Mean) / Deviation;
+
+	// a single spike can't trigger a level shift on its own
+	const double ClampedScore = FMath::Clamp(Score, -ZScoreThreshold, ZScoreThreshold);
+	PositiveSum = FMath::Max(0., PositiveSum + ClampedScore - ChangePointDrift);
+	NegativeSum = FMath::Max(0., NegativeSum - ClampedScore - ChangePointDrift);
+
+	// new level is accepted right away, so the shift is only reported once
+	if (PositiveSum > ChangePointThreshold || NegativeSum > ChangePointThreshold)
+	{
+		Mean = Value;
+		NumValuesAtLevel = 1;
+		PositiveSum = NegativeSum = 0.;
+		return EQuickStatsAnomaly::LevelShift;
+	}
+
+	// spikes are clamped before updating the mean and variance, so a single outlier doesn't hide the next ones
+	EQuickStatsAnomaly Anomaly = EQuickStatsAnomaly::None;
+	double ClampedValue = Value;
+	if (FMath::Abs(Score) > ZScoreThreshold)
+	{
+		Anomaly = EQuickStatsAnomaly::Spike;
+		ClampedValue = Mean + FMath::Sign(Score) * ZScoreThreshold * Deviation;
+	}
+
+	// mean of a new level is a plain average at first, a single noisy value would otherwise report the same shift again
+	const double Delta = ClampedValue - Mean;
+	Mean += FMath::Max(1. / NumValuesAtLevel, Alpha) * Delta;
+	Variance = (1. - Alpha) * (Variance + Alpha * Delta * Delta);
+
+	return Anomaly;
+}
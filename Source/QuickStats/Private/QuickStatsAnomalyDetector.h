@@ -0,0 +1,51 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EQuickStatsAnomaly : uint8
+{
+	None,
+	// single value far from the recent mean
+	Spike,
+	// mean of the stat moved and stayed there
+	LevelShift,
+};
+
+/*
+* Online anomaly detection for a single stat: z-score against an exponentially weighted mean and deviation,
+* plus a two sided CUSUM test on the z-scores for level shifts too small to be spikes. Constant memory, O(1) per value.
+*/
+struct FQuickStatsAnomalyDetector
+{
+	// WindowSize is the number of values the mean and deviation effectively cover, also used as warmup
+	FQuickStatsAnomalyDetector(int32 WindowSize, double InZScoreThreshold, double InChangePointThreshold);
+
+	// NaN values (stat couldn't be evaluated) are ignored
+	EQuickStatsAnomaly Add(double Value);
+
+	double GetMean() const { return Mean; }
+	// z-score of the last value
+	double GetScore() const { return Score; }
+
+private:
+	double GetDeviation() const;
+
+private:
+	double Alpha = 0.;
+	int32 NumWarmupValues = 0;
+	double ZScoreThreshold = 0.;
+	double ChangePointThreshold = 0.;
+
+	int64 NumValues = 0;
+	// values since the start or the last level shift
+	int64 NumValuesAtLevel = 0;
+	double Mean = 0.;
+	double Variance = 0.;
+	double Score = 0.;
+
+	// cumulative sums of z-scores above/below the mean
+	double PositiveSum = 0.;
+	double NegativeSum = 0.;
+};
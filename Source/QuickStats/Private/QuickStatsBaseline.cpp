@@ -0,0 +1,112 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsBaseline.h"
+
+#if STATS
+
+#include "QuickStatSettings.h"
+#include "QuickStatsSummary.h"
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+
+TUniquePtr<FQuickStatsBaseline> FQuickStatsBaseline::Load(const FString& FilePath)
+{
+	FString Json;
+	if (!FFileHelper::LoadFileToString(Json, *FilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to read baseline %s"), *FilePath);
+		return nullptr;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	const TArray<TSharedPtr<FJsonValue>>* StatValues = nullptr;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("Stats"), StatValues))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Baseline %s is not a session report"), *FilePath);
+		return nullptr;
+	}
+
+	TUniquePtr<FQuickStatsBaseline> Baseline = MakeUnique<FQuickStatsBaseline>();
+	Baseline->FilePath = FilePath;
+
+	for (const TSharedPtr<FJsonValue>& StatValue : *StatValues)
+	{
+		const TSharedPtr<FJsonObject>* StatObject = nullptr;
+		if (!StatValue.IsValid() || !StatValue->TryGetObject(StatObject))
+		{
+			continue;
+		}
+
+		// stats without valid frames don't have a summary
+		FString PresetName;
+		FStatBaseline StatBaseline;
+		if ((*StatObject)->TryGetStringField(TEXT("Preset"), PresetName)
+			&& (*StatObject)->TryGetStringField(TEXT("Stat"), StatBaseline.StatDescription)
+			&& (*StatObject)->TryGetNumberField(TEXT("Mean"), StatBaseline.Mean)
+			&& (*StatObject)->TryGetNumberField(TEXT("P50"), StatBaseline.P50)
+			&& (*StatObject)->TryGetNumberField(TEXT("P95"), StatBaseline.P95)
+			&& (*StatObject)->TryGetNumberField(TEXT("P99"), StatBaseline.P99))
+		{
+			StatBaseline.PresetName = FName(*PresetName);
+			Baseline->Stats.Add(MoveTemp(StatBaseline));
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] Loaded baseline %s (%d stats)"), *FilePath, Baseline->Stats.Num());
+	return Baseline;
+}
+
+bool FQuickStatsBaseline::FindValue(FName PresetName, const FString& StatDescription, EQuickStatBaselineMetric Metric, double& OutValue) const
+{
+	const FStatBaseline* StatBaseline = Stats.FindByPredicate([&](const FStatBaseline& Stat) { return Stat.PresetName == PresetName && Stat.StatDescription == StatDescription; });
+	if (!StatBaseline)
+	{
+		return false;
+	}
+
+	switch (Metric)
+	{
+	case EQuickStatBaselineMetric::P50:		OutValue = StatBaseline->P50; break;
+	case EQuickStatBaselineMetric::P95:		OutValue = StatBaseline->P95; break;
+	case EQuickStatBaselineMetric::P99:		OutValue = StatBaseline->P99; break;
+	default:								OutValue = StatBaseline->Mean; break;
+	}
+	return true;
+}
+
+void FQuickStatsBaseline::GetStatNames(TArray<TPair<FName, FString>>& OutStatNames) const
+{
+	OutStatNames.Reset(Stats.Num());
+	for (const FStatBaseline& Stat : Stats)
+	{
+		OutStatNames.Emplace(Stat.PresetName, Stat.StatDescription);
+	}
+}
+
+double FQuickStatsBaseline::GetRelativeDelta(double Value, double BaselineValue)
+{
+	return (FMath::Abs(BaselineValue) > SMALL_NUMBER) ? (Value - BaselineValue) / FMath::Abs(BaselineValue) : 0.;
+}
+
+double FQuickStatsBaseline::GetToleranceRatio(double Value, double BaselineValue, double RelativeTolerance, double AbsoluteTolerance)
+{
+	// dividing by the larger allowed change means the ratio only goes over 1 once both tolerances are exceeded
+	const double AllowedDelta = FMath::Max3(FMath::Abs(BaselineValue) * RelativeTolerance, AbsoluteTolerance, (double)SMALL_NUMBER);
+	return (Value - BaselineValue) / AllowedDelta;
+}
+
+double FQuickStatsBaseline::GetSummaryValue(const FQuickStatsSummary& Summary, EQuickStatBaselineMetric Metric)
+{
+	switch (Metric)
+	{
+	case EQuickStatBaselineMetric::P50:		return Summary.P50.Get();
+	case EQuickStatBaselineMetric::P95:		return Summary.P95.Get();
+	case EQuickStatBaselineMetric::P99:		return Summary.P99.Get();
+	default:								return Summary.GetMean();
+	}
+}
+
+#endif //#if STATS
@@ -0,0 +1,54 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+enum class EQuickStatBaselineMetric : uint8;
+struct FQuickStatsSummary;
+
+/*
+* Stat summaries of an earlier run (session report JSON written by qstats.Report), live stats are compared against it.
+*/
+class FQuickStatsBaseline
+{
+public:
+	// returns nullptr if the file can't be read or isn't a session report
+	static TUniquePtr<FQuickStatsBaseline> Load(const FString& FilePath);
+
+	// false if the stat wasn't recorded in the baseline
+	bool FindValue(FName PresetName, const FString& StatDescription, EQuickStatBaselineMetric Metric, double& OutValue) const;
+
+	const FString& GetFilePath() const { return FilePath; }
+
+	// stats recorded in the baseline as (preset, stat description)
+	void GetStatNames(TArray<TPair<FName, FString>>& OutStatNames) const;
+
+	// relative change from baseline, positive values are regressions. 0 if the baseline is 0, its change can't be relative
+	static double GetRelativeDelta(double Value, double BaselineValue);
+
+	// change from baseline as a fraction of the allowed change, > 1 is a regression and < -1 an improvement past the tolerance.
+	// change has to exceed both the relative and the absolute tolerance
+	static double GetToleranceRatio(double Value, double BaselineValue, double RelativeTolerance, double AbsoluteTolerance);
+
+	// value of a live summary comparable with the baseline
+	static double GetSummaryValue(const FQuickStatsSummary& Summary, EQuickStatBaselineMetric Metric);
+
+private:
+	struct FStatBaseline
+	{
+		FName PresetName = NAME_None;
+		FString StatDescription;
+		double Mean = 0.;
+		double P50 = 0.;
+		double P95 = 0.;
+		double P99 = 0.;
+	};
+
+	FString FilePath;
+	TArray<FStatBaseline> Stats;
+};
+
+#endif //#if STATS
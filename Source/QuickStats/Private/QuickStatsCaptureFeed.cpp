@@ -0,0 +1,182 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsCaptureFeed.h"
+
+#if STATS
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+FQuickStatsCaptureFeed::FQuickStatsCaptureFeed(int32 InSegmentFrames, int64 InSegmentBytes)
+	: SegmentFrames(FMath::Max(InSegmentFrames, 0))
+	, SegmentBytes(FMath::Max<int64>(InSegmentBytes, 0))
+{
+}
+
+FQuickStatsCaptureFeed::~FQuickStatsCaptureFeed()
+{
+	WriteCapture();
+
+	for (TFuture<void>& PendingWrite : PendingWrites)
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void FQuickStatsCaptureFeed::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	// columns can't change within a file
+	WriteCapture();
+
+	Capture = FCapture();
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		Capture.PresetNames.Add(Stat.PresetName);
+		Capture.StatDescriptions.Add(Stat.StatDescription);
+		Capture.Budgets.Add(Stat.Budget);
+	}
+	Capture.Columns.SetNum(Stats.Num());
+}
+
+void FQuickStatsCaptureFeed::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (Values.Num() != Capture.Columns.Num())
+	{
+		return;
+	}
+
+	if (Capture.NumFrames == 0)
+	{
+		Capture.StartTime = FDateTime::UtcNow();
+		Capture.FirstFrameTime = Time;
+	}
+
+	Capture.FrameNumbers.Add(static_cast<double>(FrameNumber));
+	Capture.FrameTimes.Add(FMath::RoundToDouble((Time - Capture.FirstFrameTime) * 1000000.));
+	int64 NumBytes = Capture.FrameNumbers.GetData().Num() + Capture.FrameTimes.GetData().Num();
+	for (int32 StatIndex = 0; StatIndex < Values.Num(); ++StatIndex)
+	{
+		Capture.Columns[StatIndex].Add(Values[StatIndex]);
+		NumBytes += Capture.Columns[StatIndex].GetData().Num();
+	}
+	Capture.NumFrames++;
+
+	// long sessions are split into segments instead of growing the columns until the end
+	if ((SegmentFrames > 0 && Capture.NumFrames >= SegmentFrames) || (SegmentBytes > 0 && NumBytes >= SegmentBytes))
+	{
+		WriteCapture();
+	}
+}
+
+void FQuickStatsCaptureFeed::WriteCapture()
+{
+	if (Capture.NumFrames == 0)
+	{
+		return;
+	}
+
+	// milliseconds keep captures of quick schema changes apart
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("QuickStats") / TEXT("Captures")
+		/ FString::Printf(TEXT("Capture_%s%s"), *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S.%s")), ANSI_TO_TCHAR(QuickStatsCapture::FileExtension));
+
+	FCapture FinishedCapture = MoveTemp(Capture);
+
+	// next capture continues with the same schema
+	Capture = FCapture();
+	Capture.PresetNames = FinishedCapture.PresetNames;
+	Capture.StatDescriptions = FinishedCapture.StatDescriptions;
+	Capture.Budgets = FinishedCapture.Budgets;
+	Capture.Columns.SetNum(FinishedCapture.Columns.Num());
+
+	PendingWrites.RemoveAll([](const TFuture<void>& PendingWrite) { return PendingWrite.IsReady(); });
+	PendingWrites.Add(Async(EAsyncExecution::ThreadPool, [FinishedCapture = MoveTemp(FinishedCapture), FilePath]() { WriteCaptureFile(FinishedCapture, FilePath); }));
+}
+
+void FQuickStatsCaptureFeed::WriteCaptureFile(const FCapture& Capture, const FString& FilePath)
+{
+	using namespace QuickStatsCapture;
+
+	const int32 NumStats = Capture.Columns.Num();
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumStats = NumStats;
+	Header.NumFrames = Capture.NumFrames;
+	Header.StartTimeTicks = Capture.StartTime.GetTicks();
+
+	TArray<FStat> Stats;
+	Stats.SetNumZeroed(NumStats);
+
+	TArray<uint8> Strings;
+	auto AddString = [&Strings](const FString& String)
+	{
+		const uint32 Offset = Strings.Num();
+		FTCHARToUTF8 Utf8String(*String);
+		Strings.Append(reinterpret_cast<const uint8*>(Utf8String.Get()), Utf8String.Length());
+		Strings.Add(0);
+		return Offset;
+	};
+
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		Stats[StatIndex].Budget = Capture.Budgets[StatIndex];
+		Stats[StatIndex].PresetNameOffset = AddString(Capture.PresetNames[StatIndex].ToString());
+		Stats[StatIndex].StatDescriptionOffset = AddString(Capture.StatDescriptions[StatIndex]);
+	}
+
+	// columns follow the strings in the order of the header
+	uint64 Offset = sizeof(FHeader) + sizeof(FStat) * NumStats;
+	Header.StringsOffset = Offset;
+	Header.StringsSize = Strings.Num();
+	Offset += Strings.Num();
+
+	auto PlaceColumn = [&Offset](const FQuickStatsColumnWriter& ColumnWriter, FColumn& OutColumn)
+	{
+		OutColumn.Offset = Offset;
+		OutColumn.Size = ColumnWriter.GetData().Num();
+		OutColumn.Encoding = ColumnWriter.GetEncoding();
+		Offset += OutColumn.Size;
+	};
+
+	PlaceColumn(Capture.FrameNumbers, Header.FrameNumbers);
+	PlaceColumn(Capture.FrameTimes, Header.FrameTimes);
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		PlaceColumn(Capture.Columns[StatIndex], Stats[StatIndex].Values);
+	}
+
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*FilePath));
+	if (!Writer)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to create capture %s"), *FilePath);
+		return;
+	}
+
+	auto WriteBytes = [&Writer](const void* Bytes, int64 NumBytes)
+	{
+		Writer->Serialize(const_cast<void*>(Bytes), NumBytes);
+	};
+
+	WriteBytes(&Header, sizeof(Header));
+	WriteBytes(Stats.GetData(), sizeof(FStat) * NumStats);
+	WriteBytes(Strings.GetData(), Strings.Num());
+	WriteBytes(Capture.FrameNumbers.GetData().GetData(), Capture.FrameNumbers.GetData().Num());
+	WriteBytes(Capture.FrameTimes.GetData().GetData(), Capture.FrameTimes.GetData().Num());
+	for (const FQuickStatsColumnWriter& Column : Capture.Columns)
+	{
+		WriteBytes(Column.GetData().GetData(), Column.GetData().Num());
+	}
+
+	if (!Writer->Close())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write capture %s"), *FilePath);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] Capture (%d frames, %d stats, %llu bytes) written to %s"), Capture.NumFrames, NumStats, Offset, *FilePath);
+}
+
+#endif //#if STATS
@@ -0,0 +1,56 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+#include "QuickStatsColumnCodec.h"
+#include "Async/Future.h"
+
+/*
+* Records values of all evaluated stats into compressed columns (QuickStatsCaptureFormat.h).
+* A capture file is written to Saved/QuickStats/Captures when the schema changes, when the feed is destroyed and whenever
+* the capture reaches the segment limits, so memory stays bounded during long sessions.
+*/
+class FQuickStatsCaptureFeed : public IQuickStatsFeed
+{
+public:
+	// limits of 0 are ignored
+	FQuickStatsCaptureFeed(int32 InSegmentFrames, int64 InSegmentBytes);
+	virtual ~FQuickStatsCaptureFeed();
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+private:
+	struct FCapture
+	{
+		FDateTime StartTime;
+		double FirstFrameTime = 0.;
+		int32 NumFrames = 0;
+
+		TArray<FName> PresetNames;
+		TArray<FString> StatDescriptions;
+		TArray<double> Budgets;
+
+		FQuickStatsColumnWriter FrameNumbers;
+		FQuickStatsColumnWriter FrameTimes;
+		TArray<FQuickStatsColumnWriter> Columns;
+	};
+
+	// hands the capture over to a worker thread and starts a new one with the same schema
+	void WriteCapture();
+	static void WriteCaptureFile(const FCapture& Capture, const FString& FilePath);
+
+private:
+	const int32 SegmentFrames;
+	const int64 SegmentBytes;
+
+	FCapture Capture;
+	TArray<TFuture<void>> PendingWrites;
+};
+
+#endif //#if STATS
@@ -0,0 +1,160 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsCaptureReader.h"
+#include "QuickStatsColumnCodec.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+
+using namespace QuickStatsCapture;
+
+FQuickStatsCaptureReader::~FQuickStatsCaptureReader()
+{
+	// region has to be unmapped before the file is closed
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TUniquePtr<FQuickStatsCaptureReader> FQuickStatsCaptureReader::Open(const FString& FilePath)
+{
+	TUniquePtr<FQuickStatsCaptureReader> Reader(new FQuickStatsCaptureReader());
+	Reader->FilePath = FilePath;
+
+	Reader->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (Reader->MappedFile)
+	{
+		Reader->MappedRegion.Reset(Reader->MappedFile->MapRegion());
+	}
+
+	if (Reader->MappedRegion)
+	{
+		Reader->Data = Reader->MappedRegion->GetMappedPtr();
+		Reader->Size = Reader->MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(Reader->FileData, *FilePath, FILEREAD_Silent))
+	{
+		Reader->Data = Reader->FileData.GetData();
+		Reader->Size = Reader->FileData.Num();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to read capture %s"), *FilePath);
+		return nullptr;
+	}
+
+	if (!Reader->ParseHeader())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] %s is not a valid capture"), *FilePath);
+		return nullptr;
+	}
+	return Reader;
+}
+
+bool FQuickStatsCaptureReader::ParseHeader()
+{
+	if (Size < sizeof(FHeader))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, Data, sizeof(FHeader));
+	if (Header.Magic != Magic || Header.Version != Version || Header.NumFrames > MAX_int32)
+	{
+		return false;
+	}
+
+	const uint64 StatsSize = static_cast<uint64>(Header.NumStats) * sizeof(FStat);
+	if (StatsSize > Size - sizeof(FHeader))
+	{
+		return false;
+	}
+
+	// strings are null terminated, the block has to end with a terminator
+	if (Header.StringsOffset > Size || Header.StringsSize > Size - Header.StringsOffset || (Header.NumStats > 0 && (Header.StringsSize == 0 || Data[Header.StringsOffset + Header.StringsSize - 1] != 0)))
+	{
+		return false;
+	}
+
+	if (!IsColumnValid(Header.FrameNumbers) || !IsColumnValid(Header.FrameTimes))
+	{
+		return false;
+	}
+
+	Stats.SetNumUninitialized(Header.NumStats);
+	FMemory::Memcpy(Stats.GetData(), Data + sizeof(FHeader), StatsSize);
+
+	const char* Strings = reinterpret_cast<const char*>(Data + Header.StringsOffset);
+	for (const FStat& Stat : Stats)
+	{
+		if (Stat.PresetNameOffset >= Header.StringsSize || Stat.StatDescriptionOffset >= Header.StringsSize || !IsColumnValid(Stat.Values))
+		{
+			return false;
+		}
+
+		PresetNames.Add(FName(UTF8_TO_TCHAR(Strings + Stat.PresetNameOffset)));
+		StatDescriptions.Add(UTF8_TO_TCHAR(Strings + Stat.StatDescriptionOffset));
+	}
+	return true;
+}
+
+bool FQuickStatsCaptureReader::IsColumnValid(const FColumn& Column) const
+{
+	return Column.Offset <= Size && Column.Size <= Size - Column.Offset
+		&& (Column.Encoding == EColumnEncoding::DeltaVarint || Column.Encoding == EColumnEncoding::XorFloat);
+}
+
+int32 FQuickStatsCaptureReader::FindStat(FName PresetName, const FString& StatDescription) const
+{
+	for (int32 StatIndex = 0; StatIndex < Stats.Num(); ++StatIndex)
+	{
+		if (PresetNames[StatIndex] == PresetName && StatDescriptions[StatIndex] == StatDescription)
+		{
+			return StatIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FQuickStatsCaptureReader::ForEachValue(const FColumn& Column, TFunctionRef<void(int32 FrameIndex, double Value)> Visitor) const
+{
+	const int32 NumFrames = Header.NumFrames;
+	FQuickStatsColumnReader ColumnReader(Column.Encoding, Data + Column.Offset, Column.Size, NumFrames);
+
+	int32 FrameIndex = 0;
+	double Value;
+	while (ColumnReader.Next(Value))
+	{
+		Visitor(FrameIndex++, Value);
+	}
+
+	if (FrameIndex != NumFrames)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Capture %s has a malformed column at offset %llu"), *FilePath, Column.Offset);
+		return false;
+	}
+	return true;
+}
+
+bool FQuickStatsCaptureReader::ForEachStatValue(int32 StatIndex, TFunctionRef<void(int32 FrameIndex, double Value)> Visitor) const
+{
+	return Stats.IsValidIndex(StatIndex) && ForEachValue(Stats[StatIndex].Values, Visitor);
+}
+
+bool FQuickStatsCaptureReader::ReadStatValues(int32 StatIndex, TArray<double>& OutValues) const
+{
+	OutValues.Reset(Header.NumFrames);
+	return ForEachStatValue(StatIndex, [&OutValues](int32 FrameIndex, double Value) { OutValues.Add(Value); });
+}
+
+bool FQuickStatsCaptureReader::ReadFrameNumbers(TArray<uint64>& OutFrameNumbers) const
+{
+	OutFrameNumbers.Reset(Header.NumFrames);
+	return ForEachValue(Header.FrameNumbers, [&OutFrameNumbers](int32 FrameIndex, double Value) { OutFrameNumbers.Add(static_cast<uint64>(Value)); });
+}
+
+bool FQuickStatsCaptureReader::ReadFrameTimes(TArray<double>& OutFrameTimes) const
+{
+	OutFrameTimes.Reset(Header.NumFrames);
+	return ForEachValue(Header.FrameTimes, [&OutFrameTimes](int32 FrameIndex, double Value) { OutFrameTimes.Add(Value / 1000000.); });
+}
@@ -0,0 +1,293 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsCollector.h"
+
+#if STATS
+
+#include "Runtime/Launch/Resources/Version.h"
+#include "Async/TaskGraphInterfaces.h"
+
+struct FRequiredStatsFilter : public IItemFilter
+{
+	FRequiredStatsFilter(FQuickStatsCollector& InCollector) : Collector(InCollector) {}
+
+	virtual bool Keep(const FStatMessage& Item) override { return Collector.IsStatRequired(Item); }
+
+	FQuickStatsCollector& Collector;
+};
+
+static FGraphEventRef DispatchToStatsThread(const FSimpleDelegateGraphTask::FDelegate& Delegate)
+{
+	// stats are processed on the game thread if there is no stats thread
+	const ENamedThreads::Type StatsThread = FPlatformProcess::SupportsMultithreading() ? ENamedThreads::StatsThread : ENamedThreads::GameThread;
+	return FSimpleDelegateGraphTask::CreateAndDispatchWhenReady(Delegate, TStatId(), nullptr, StatsThread);
+}
+
+static void EnableStatsCollection(bool bEnable)
+{
+#if (ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1))
+	bEnable ? FThreadStats::PrimaryEnableAdd() : FThreadStats::PrimaryEnableSubtract();
+#else
+	bEnable ? FThreadStats::MasterEnableAdd() : FThreadStats::MasterEnableSubtract();
+#endif
+}
+
+FQuickStatsCollector::FQuickStatsCollector()
+{
+	QueuedFrames.SetNum(MaxQueuedFrames);
+	EngineSnapshots.SetNum(MaxEngineSnapshots);
+
+	// NewFrameDelegate is broadcast by the stats thread, it's only safe to bind there
+	DispatchToStatsThread(FSimpleDelegateGraphTask::FDelegate::CreateRaw(this, &FQuickStatsCollector::BindToStatsThread));
+}
+
+FQuickStatsCollector::~FQuickStatsCollector()
+{
+	if (bIsCollectingStats)
+	{
+		EnableStatsCollection(false);
+	}
+
+	for (FName StatGroupName : EnabledStatGroups)
+	{
+		IStatGroupEnableManager::Get().SetHighPerformanceEnableForGroup(StatGroupName, false);
+	}
+
+	if (FTaskGraphInterface::IsRunning())
+	{
+		FGraphEventRef UnbindEvent = DispatchToStatsThread(FSimpleDelegateGraphTask::FDelegate::CreateRaw(this, &FQuickStatsCollector::UnbindFromStatsThread));
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(UnbindEvent, ENamedThreads::GameThread);
+	}
+	else
+	{
+		UnbindFromStatsThread();
+	}
+}
+
+void FQuickStatsCollector::SetRequiredStats(bool bInCollectFrames, const TSet<FName>& StatNames, const TSet<FName>& StatGroupNames)
+{
+	// stats are only enabled if code stats are read, engine globals don't need them
+	const bool bShouldCollectStats = bInCollectFrames && StatNames.Num() > 0;
+	{
+		FScopeLock Lock(&RequiredStatsLock);
+		PendingRequiredStatNames = StatNames;
+		bPendingCollectStats = bShouldCollectStats;
+		bRequiredStatsChanged = true;
+	}
+
+	// stats of disabled groups are not recorded at all (verbose groups are disabled by default)
+	for (FName StatGroupName : StatGroupNames)
+	{
+		if (StatGroupName != NAME_None && !EnabledStatGroups.Contains(StatGroupName))
+		{
+			IStatGroupEnableManager::Get().SetHighPerformanceEnableForGroup(StatGroupName, true);
+			EnabledStatGroups.Add(StatGroupName);
+		}
+	}
+
+	// groups we enabled are disabled again once no preset reads them
+	for (auto It = EnabledStatGroups.CreateIterator(); It; ++It)
+	{
+		if (!StatGroupNames.Contains(*It))
+		{
+			IStatGroupEnableManager::Get().SetHighPerformanceEnableForGroup(*It, false);
+			It.RemoveCurrent();
+		}
+	}
+
+	if (bShouldCollectStats != bIsCollectingStats)
+	{
+		EnableStatsCollection(bShouldCollectStats);
+		bIsCollectingStats = bShouldCollectStats;
+	}
+	bIsCollecting = bInCollectFrames;
+
+	if (!bIsCollecting)
+	{
+		FScopeLock Lock(&FrameLock);
+		NumQueuedFrames = 0;
+		NumDroppedFrames = 0;
+	}
+}
+
+void FQuickStatsCollector::QueueFrame(int64 FrameNumber, double FrameDuration)
+{
+	FScopeLock Lock(&FrameLock);
+	FCollectedFrame& Frame = AddQueuedFrame();
+	Frame.FrameNumber = FrameNumber;
+	Frame.Time = FPlatformTime::Seconds();
+	Frame.FrameDuration = FrameDuration;
+	Frame.EngineSnapshot = FQuickStatEngineSnapshot::Capture();
+	Frame.Stats.Reset();
+}
+
+void FQuickStatsCollector::RecordEngineSnapshot()
+{
+	if (!bIsCollectingStats)
+	{
+		return;
+	}
+
+	// stats frame the game thread is recording, the stats thread delivers it with the same number
+	const int64 FrameNumber = FStats::GameThreadStatsFrame;
+	FEngineSnapshotSlot& Slot = EngineSnapshots[FrameNumber % MaxEngineSnapshots];
+	Slot.FrameNumber = FrameNumber;
+	Slot.Snapshot = FQuickStatEngineSnapshot::Capture();
+}
+
+int32 FQuickStatsCollector::GetNumQueuedFrames()
+{
+	FScopeLock Lock(&FrameLock);
+	return NumQueuedFrames;
+}
+
+bool FQuickStatsCollector::PopFrame()
+{
+	uint32 NumFramesDropped = 0;
+	{
+		FScopeLock Lock(&FrameLock);
+		if (NumQueuedFrames == 0)
+		{
+			return false;
+		}
+
+		Swap(QueuedFrames[FirstQueuedFrame], CurrentFrame);
+		FirstQueuedFrame = (FirstQueuedFrame + 1) % MaxQueuedFrames;
+		NumQueuedFrames--;
+
+		NumFramesDropped = NumDroppedFrames;
+		NumDroppedFrames = 0;
+	}
+
+	if (NumFramesDropped > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[QuickStat] %u stats frames were dropped, they weren't consumed in time."), NumFramesDropped);
+	}
+
+	// frames of the stats thread pick up the snapshot recorded when they ended on the game thread
+	if (!CurrentFrame.EngineSnapshot.bIsValid)
+	{
+		const FEngineSnapshotSlot& Slot = EngineSnapshots[CurrentFrame.FrameNumber % MaxEngineSnapshots];
+		if (Slot.FrameNumber == CurrentFrame.FrameNumber)
+		{
+			CurrentFrame.EngineSnapshot = Slot.Snapshot;
+		}
+	}
+
+	Stats.Reset();
+	CounterStats.Reset();
+	for (const FComplexStatMessage& StatMessage : CurrentFrame.Stats)
+	{
+		if (StatMessage.NameAndInfo.GetFlag(EStatMetaFlags::IsCycle))
+		{
+			Stats.Add(StatMessage.GetShortName(), &StatMessage);
+		}
+		else
+		{
+			CounterStats.Add(StatMessage.GetShortName(), &StatMessage);
+		}
+	}
+
+	return true;
+}
+
+void FQuickStatsCollector::BindToStatsThread()
+{
+	NewFrameHandle = FStatsThreadState::GetLocalState().NewFrameDelegate.AddRaw(this, &FQuickStatsCollector::OnNewStatsFrame);
+}
+
+void FQuickStatsCollector::UnbindFromStatsThread()
+{
+	FStatsThreadState::GetLocalState().NewFrameDelegate.Remove(NewFrameHandle);
+	NewFrameHandle.Reset();
+}
+
+void FQuickStatsCollector::OnNewStatsFrame(int64 Frame)
+{
+	{
+		FScopeLock Lock(&RequiredStatsLock);
+		if (bRequiredStatsChanged)
+		{
+			RequiredStatNames = PendingRequiredStatNames;
+			bCollectStats = bPendingCollectStats;
+			IsRequiredByName.Reset();
+			bRequiredStatsChanged = false;
+		}
+	}
+
+	if (!bCollectStats)
+	{
+		return;
+	}
+
+	const FStatsThreadState& StatsState = FStatsThreadState::GetLocalState();
+	if (!StatsState.IsFrameValid(Frame))
+	{
+		return;
+	}
+
+	FRequiredStatsFilter Filter(*this);
+	AggregatedStats.Reset();
+	StatsState.GetInclusiveAggregateStackStats(Frame, AggregatedStats, &Filter, true);
+
+	ScratchFrame.FrameNumber = Frame;
+	ScratchFrame.Time = FPlatformTime::Seconds();
+	// game thread time recorded with the frame, the game thread frame scope covers the whole engine tick
+	ScratchFrame.FrameDuration = FPlatformTime::ToMilliseconds64(StatsState.GetFastThreadFrameTime(Frame, EThreadType::Game));
+	ScratchFrame.EngineSnapshot = FQuickStatEngineSnapshot();
+	ScratchFrame.Stats.Reset(AggregatedStats.Num());
+	for (const FStatMessage& StatMessage : AggregatedStats)
+	{
+		// counters are added without going through the filter
+		if (!IsStatRequired(StatMessage))
+		{
+			continue;
+		}
+
+		FComplexStatMessage& CollectedStat = ScratchFrame.Stats.Emplace_GetRef(StatMessage);
+
+		// a single frame is aggregated, average and max are the frame value
+		if (StatMessage.NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_double)
+		{
+			CollectedStat.GetValue_double(EComplexStatField::IncAve) = StatMessage.GetValue_double();
+			CollectedStat.GetValue_double(EComplexStatField::IncMax) = StatMessage.GetValue_double();
+		}
+		else if (StatMessage.NameAndInfo.GetField<EStatDataType>() == EStatDataType::ST_int64)
+		{
+			CollectedStat.GetValue_int64(EComplexStatField::IncAve) = StatMessage.GetValue_int64();
+			CollectedStat.GetValue_int64(EComplexStatField::IncMax) = StatMessage.GetValue_int64();
+		}
+	}
+
+	FScopeLock Lock(&FrameLock);
+	Swap(AddQueuedFrame(), ScratchFrame);
+}
+
+FQuickStatsCollector::FCollectedFrame& FQuickStatsCollector::AddQueuedFrame()
+{
+	if (NumQueuedFrames == MaxQueuedFrames)
+	{
+		FirstQueuedFrame = (FirstQueuedFrame + 1) % MaxQueuedFrames;
+		NumQueuedFrames--;
+		NumDroppedFrames++;
+	}
+
+	FCollectedFrame& Frame = QueuedFrames[(FirstQueuedFrame + NumQueuedFrames) % MaxQueuedFrames];
+	NumQueuedFrames++;
+	return Frame;
+}
+
+bool FQuickStatsCollector::IsStatRequired(const FStatMessage& StatMessage)
+{
+	const FName LongName = StatMessage.NameAndInfo.GetRawName();
+	if (const bool* bIsRequired = IsRequiredByName.Find(LongName))
+	{
+		return *bIsRequired;
+	}
+
+	const bool bIsRequired = RequiredStatNames.Contains(StatMessage.NameAndInfo.GetShortName());
+	IsRequiredByName.Add(LongName, bIsRequired);
+	return bIsRequired;
+}
+
+#endif //#if STATS
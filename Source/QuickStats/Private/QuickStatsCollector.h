@@ -0,0 +1,117 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatExpressions.h"
+#include "Stats/StatsData.h"
+
+/*
+* Aggregates only the stats read by enabled presets on the stats thread and queues every frame for the game thread.
+* Enabling whole stat groups with `stat` commands makes the stats thread condense and ship every stat of the group.
+* Frames are consumed in order, so aggregates don't depend on how often the game thread samples stats.
+*/
+class FQuickStatsCollector
+{
+public:
+	FQuickStatsCollector();
+	~FQuickStatsCollector();
+
+	// stats to aggregate from the next stats frame, frames are queued while collecting even if no stat is required
+	void SetRequiredStats(bool bInCollectFrames, const TSet<FName>& StatNames, const TSet<FName>& StatGroupNames);
+
+	// stats thread is only involved if code stats are required, otherwise the game thread queues frames with QueueFrame
+	bool IsCollectingStats() const { return bIsCollectingStats; }
+	// queues a frame without code stats (expressions reading engine globals or platform memory), frame duration in ms
+	void QueueFrame(int64 FrameNumber, double FrameDuration);
+	// snapshot of engine globals for the stats frame ending on the game thread, picked up when the stats thread delivers the frame
+	void RecordEngineSnapshot();
+
+	// frames aggregated by the stats thread and not consumed yet
+	int32 GetNumQueuedFrames();
+	// makes the oldest queued frame current, returns false if the queue is empty
+	bool PopFrame();
+
+	// stats frame number and stats thread time of the current frame
+	int64 GetFrameNumber() const { return CurrentFrame.FrameNumber; }
+	double GetFrameTime() const { return CurrentFrame.Time; }
+	// frame time (ms) of the current frame itself, frames are collected in bursts so their Time deltas aren't frame times
+	double GetFrameDuration() const { return CurrentFrame.FrameDuration; }
+	// engine globals of the current frame, invalid if the frame ended before it was recorded
+	const FQuickStatEngineSnapshot& GetEngineSnapshot() const { return CurrentFrame.EngineSnapshot; }
+
+	// cycle stats and counters of the current frame by short name
+	const TMap<FName, const FComplexStatMessage*>& GetStats() const { return Stats; }
+	const TMap<FName, const FComplexStatMessage*>& GetCounterStats() const { return CounterStats; }
+
+private:
+	friend struct FRequiredStatsFilter;
+
+	struct FCollectedFrame
+	{
+		int64 FrameNumber = 0;
+		double Time = 0.;
+		double FrameDuration = 0.;
+		FQuickStatEngineSnapshot EngineSnapshot;
+		TArray<FComplexStatMessage> Stats;
+	};
+
+	struct FEngineSnapshotSlot
+	{
+		int64 FrameNumber = INDEX_NONE;
+		FQuickStatEngineSnapshot Snapshot;
+	};
+
+	// oldest frames are dropped if the game thread doesn't consume them (game thread stalled for a long time)
+	static constexpr int32 MaxQueuedFrames = 64;
+	// frames can also be in flight on the stats thread, snapshots are kept a while longer than queued frames
+	static constexpr int32 MaxEngineSnapshots = MaxQueuedFrames * 2;
+
+	// stats thread
+	void BindToStatsThread();
+	void UnbindFromStatsThread();
+	void OnNewStatsFrame(int64 Frame);
+	bool IsStatRequired(const FStatMessage& Message);
+	// slot for a new frame, drops the oldest frame if the queue is full, FrameLock must be held
+	FCollectedFrame& AddQueuedFrame();
+
+private:
+	bool bIsCollecting = false;
+	bool bIsCollectingStats = false;
+	// groups enabled by this collector, disabled again when no preset reads them
+	TSet<FName> EnabledStatGroups;
+
+	// written by the game thread, picked up by the stats thread on the next frame
+	FCriticalSection RequiredStatsLock;
+	TSet<FName> PendingRequiredStatNames;
+	bool bPendingCollectStats = false;
+	bool bRequiredStatsChanged = false;
+
+	// owned by the stats thread
+	FDelegateHandle NewFrameHandle;
+	bool bCollectStats = false;
+	TSet<FName> RequiredStatNames;
+	// parsing short names is expensive, filter results are cached by long name
+	TMap<FName, bool> IsRequiredByName;
+	TArray<FStatMessage> AggregatedStats;
+	FCollectedFrame ScratchFrame;
+
+	// ring of frames, frames are swapped in and out so their memory is reused
+	FCriticalSection FrameLock;
+	TArray<FCollectedFrame> QueuedFrames;
+	int32 FirstQueuedFrame = 0;
+	int32 NumQueuedFrames = 0;
+	uint32 NumDroppedFrames = 0;
+
+	// owned by the game thread
+	FCollectedFrame CurrentFrame;
+	// indexed by stats frame number modulo MaxEngineSnapshots
+	TArray<FEngineSnapshotSlot> EngineSnapshots;
+	TMap<FName, const FComplexStatMessage*> Stats;
+	TMap<FName, const FComplexStatMessage*> CounterStats;
+};
+
+#endif //#if STATS
@@ -0,0 +1,274 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsColumnCodec.h"
+#include "QuickStatsStreamProtocol.h"
+
+using namespace QuickStatsCapture;
+
+// integers beyond 2^53 can't be represented exactly by a double
+static constexpr double MaxExactInteger = 9007199254740992.;
+
+static uint64 ZigZagEncode(int64 Value)
+{
+	return (static_cast<uint64>(Value) << 1) ^ static_cast<uint64>(Value >> 63);
+}
+
+static int64 ZigZagDecode(uint64 Value)
+{
+	return static_cast<int64>(Value >> 1) ^ -static_cast<int64>(Value & 1);
+}
+
+void FQuickStatsColumnWriter::Add(double Value)
+{
+	if (Encoding == EColumnEncoding::DeltaVarint)
+	{
+		// -0 would lose its sign as an integer
+		const bool bIsInteger = FMath::IsNaN(Value) || (FMath::Abs(Value) < MaxExactInteger && Value == FMath::FloorToDouble(Value) && (Value != 0. || !std::signbit(Value)));
+		if (bIsInteger)
+		{
+			AddInteger(Value);
+			NumValues++;
+			return;
+		}
+		ConvertToFloat();
+	}
+
+	AddFloat(Value);
+	NumValues++;
+}
+
+void FQuickStatsColumnWriter::Reset()
+{
+	*this = FQuickStatsColumnWriter();
+}
+
+void FQuickStatsColumnWriter::AddInteger(double Value)
+{
+	uint64 Token = 0;
+	if (!FMath::IsNaN(Value))
+	{
+		const int64 Integer = static_cast<int64>(Value);
+		Token = ZigZagEncode(Integer - PreviousInteger) + 1;
+		PreviousInteger = Integer;
+	}
+
+	uint8 Buffer[QuickStatsStream::MaxVarintSize];
+	Data.Append(Buffer, QuickStatsStream::WriteVarint(Buffer, Token));
+}
+
+void FQuickStatsColumnWriter::AddFloat(double Value)
+{
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+
+	if (Data.Num() == 0)
+	{
+		WriteBits(Bits, 64);
+	}
+	else
+	{
+		const uint64 Xor = Bits ^ PreviousBits;
+		if (Xor == 0)
+		{
+			WriteBits(0, 1);
+		}
+		else
+		{
+			// leading zeros are stored in 5 bits
+			const int32 LeadingZeros = FMath::Min(static_cast<int32>(FPlatformMath::CountLeadingZeros64(Xor)), 31);
+			const int32 TrailingZeros = static_cast<int32>(FPlatformMath::CountTrailingZeros64(Xor));
+
+			if (PreviousLeadingZeros != INDEX_NONE && LeadingZeros >= PreviousLeadingZeros && TrailingZeros >= PreviousTrailingZeros)
+			{
+				WriteBits(0b10, 2);
+				WriteBits(Xor >> PreviousTrailingZeros, 64 - PreviousLeadingZeros - PreviousTrailingZeros);
+			}
+			else
+			{
+				const int32 MeaningfulBits = 64 - LeadingZeros - TrailingZeros;
+				WriteBits(0b11, 2);
+				WriteBits(LeadingZeros, 5);
+				WriteBits(MeaningfulBits - 1, 6);
+				WriteBits(Xor >> TrailingZeros, MeaningfulBits);
+
+				PreviousLeadingZeros = LeadingZeros;
+				PreviousTrailingZeros = TrailingZeros;
+			}
+		}
+	}
+
+	PreviousBits = Bits;
+}
+
+void FQuickStatsColumnWriter::WriteBits(uint64 Bits, int32 NumBits)
+{
+	while (NumBits > 0)
+	{
+		if (FreeBitsInLastByte == 0)
+		{
+			Data.Add(0);
+			FreeBitsInLastByte = 8;
+		}
+
+		const int32 NumBitsToWrite = FMath::Min(NumBits, FreeBitsInLastByte);
+		const uint8 Chunk = static_cast<uint8>((Bits >> (NumBits - NumBitsToWrite)) & ((1u << NumBitsToWrite) - 1));
+		Data.Last() |= Chunk << (FreeBitsInLastByte - NumBitsToWrite);
+
+		FreeBitsInLastByte -= NumBitsToWrite;
+		NumBits -= NumBitsToWrite;
+	}
+}
+
+void FQuickStatsColumnWriter::ConvertToFloat()
+{
+	// only happens once per column, values so far are decoded and added again
+	TArray<double> Values;
+	Values.Reserve(NumValues);
+
+	FQuickStatsColumnReader Reader(Encoding, Data.GetData(), Data.Num(), NumValues);
+	double Value;
+	while (Reader.Next(Value))
+	{
+		Values.Add(Value);
+	}
+
+	Reset();
+	Encoding = EColumnEncoding::XorFloat;
+	for (double ExistingValue : Values)
+	{
+		AddFloat(ExistingValue);
+	}
+	NumValues = Values.Num();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+FQuickStatsColumnReader::FQuickStatsColumnReader(EColumnEncoding InEncoding, const uint8* InData, uint64 InSize, int32 InNumValues)
+	: Encoding(InEncoding)
+	, Data(InData)
+	, Size(InSize)
+	, NumValues(InNumValues)
+{
+}
+
+bool FQuickStatsColumnReader::Next(double& OutValue)
+{
+	if (NumReadValues >= NumValues)
+	{
+		return false;
+	}
+
+	const bool bIsValid = (Encoding == EColumnEncoding::DeltaVarint) ? NextInteger(OutValue) : NextFloat(OutValue);
+	if (!bIsValid)
+	{
+		// malformed column, don't read any further
+		NumReadValues = NumValues;
+		return false;
+	}
+
+	NumReadValues++;
+	return true;
+}
+
+bool FQuickStatsColumnReader::NextInteger(double& OutValue)
+{
+	uint64 Token;
+	const uint8* Next = QuickStatsStream::ReadVarint(Data + ByteOffset, Data + Size, Token);
+	if (!Next)
+	{
+		return false;
+	}
+	ByteOffset = Next - Data;
+
+	if (Token == 0)
+	{
+		OutValue = std::numeric_limits<double>::quiet_NaN();
+	}
+	else
+	{
+		PreviousInteger += ZigZagDecode(Token - 1);
+		OutValue = static_cast<double>(PreviousInteger);
+	}
+	return true;
+}
+
+bool FQuickStatsColumnReader::NextFloat(double& OutValue)
+{
+	uint64 Bits = PreviousBits;
+
+	if (NumReadValues == 0)
+	{
+		if (!ReadBits(64, Bits))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		uint64 Control;
+		if (!ReadBits(1, Control))
+		{
+			return false;
+		}
+
+		if (Control != 0)
+		{
+			if (!ReadBits(1, Control))
+			{
+				return false;
+			}
+
+			// new window
+			if (Control != 0)
+			{
+				uint64 StoredLeadingZeros, StoredMeaningfulBits;
+				if (!ReadBits(5, StoredLeadingZeros) || !ReadBits(6, StoredMeaningfulBits))
+				{
+					return false;
+				}
+				LeadingZeros = static_cast<int32>(StoredLeadingZeros);
+				MeaningfulBits = static_cast<int32>(StoredMeaningfulBits) + 1;
+				if (LeadingZeros + MeaningfulBits > 64)
+				{
+					return false;
+				}
+			}
+			else if (LeadingZeros == INDEX_NONE)
+			{
+				return false;
+			}
+
+			uint64 Xor;
+			if (!ReadBits(MeaningfulBits, Xor))
+			{
+				return false;
+			}
+			Bits ^= Xor << (64 - LeadingZeros - MeaningfulBits);
+		}
+	}
+
+	PreviousBits = Bits;
+	FMemory::Memcpy(&OutValue, &Bits, sizeof(Bits));
+	return true;
+}
+
+bool FQuickStatsColumnReader::ReadBits(int32 NumBits, uint64& OutBits)
+{
+	if (BitOffset + NumBits > Size * 8)
+	{
+		return false;
+	}
+
+	OutBits = 0;
+	while (NumBits > 0)
+	{
+		const int32 AvailableBits = 8 - static_cast<int32>(BitOffset & 7);
+		const int32 NumBitsToRead = FMath::Min(NumBits, AvailableBits);
+		const uint8 Chunk = (Data[BitOffset >> 3] >> (AvailableBits - NumBitsToRead)) & ((1u << NumBitsToRead) - 1);
+		OutBits = (OutBits << NumBitsToRead) | Chunk;
+
+		BitOffset += NumBitsToRead;
+		NumBits -= NumBitsToRead;
+	}
+	return true;
+}
@@ -0,0 +1,75 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuickStatsCaptureFormat.h"
+
+/*
+* Encodes values of a capture column (QuickStatsCaptureFormat.h).
+* Columns start as DeltaVarint and are re-encoded as XorFloat once a fractional value is added.
+*/
+class FQuickStatsColumnWriter
+{
+public:
+	void Add(double Value);
+	void Reset();
+
+	QuickStatsCapture::EColumnEncoding GetEncoding() const { return Encoding; }
+	const TArray<uint8>& GetData() const { return Data; }
+	int32 Num() const { return NumValues; }
+
+private:
+	void AddInteger(double Value);
+	void AddFloat(double Value);
+	void WriteBits(uint64 Bits, int32 NumBits);
+	void ConvertToFloat();
+
+private:
+	QuickStatsCapture::EColumnEncoding Encoding = QuickStatsCapture::EColumnEncoding::DeltaVarint;
+	TArray<uint8> Data;
+	int32 NumValues = 0;
+
+	// DeltaVarint
+	int64 PreviousInteger = 0;
+
+	// XorFloat, leading zeros is INDEX_NONE until the first window
+	uint64 PreviousBits = 0;
+	int32 PreviousLeadingZeros = INDEX_NONE;
+	int32 PreviousTrailingZeros = 0;
+	int32 FreeBitsInLastByte = 0;
+};
+
+/*
+* Decodes values of a capture column in order, reads the data in place.
+*/
+class FQuickStatsColumnReader
+{
+public:
+	FQuickStatsColumnReader(QuickStatsCapture::EColumnEncoding InEncoding, const uint8* InData, uint64 InSize, int32 InNumValues);
+
+	// false once all the values are read or if the column is malformed
+	bool Next(double& OutValue);
+
+private:
+	bool NextInteger(double& OutValue);
+	bool NextFloat(double& OutValue);
+	bool ReadBits(int32 NumBits, uint64& OutBits);
+
+private:
+	QuickStatsCapture::EColumnEncoding Encoding;
+	const uint8* Data;
+	uint64 Size;
+	int32 NumValues;
+	int32 NumReadValues = 0;
+
+	// DeltaVarint
+	uint64 ByteOffset = 0;
+	int64 PreviousInteger = 0;
+
+	// XorFloat
+	uint64 BitOffset = 0;
+	uint64 PreviousBits = 0;
+	int32 LeadingZeros = INDEX_NONE;
+	int32 MeaningfulBits = 0;
+};
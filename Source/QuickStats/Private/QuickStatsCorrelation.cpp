@@ -0,0 +1,243 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsCorrelation.h"
+
+#if STATS
+
+static constexpr double RelativeEpsilon = 1e-12;
+
+FQuickStatsCorrelation::FQuickStatsCorrelation(int32 InWindowSize, const FString& InTargetName)
+	: WindowSize(FMath::Max(InWindowSize, 2))
+	, TargetName(InTargetName)
+{
+}
+
+void FQuickStatsCorrelation::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	NumStats = Stats.Num();
+	StatNames.Reset(NumStats);
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		StatNames.Add(Stat.PresetName.ToString() + TEXT("/") + Stat.StatDescription);
+	}
+
+	// all the memory is allocated here, frames only update the sums
+	RingValues.SetNumUninitialized(WindowSize * NumStats);
+	RingValidity.SetNumUninitialized(WindowSize * NumStats);
+	RingTargets.SetNumUninitialized(WindowSize);
+	Shifts.SetNumUninitialized(NumStats);
+	Counts.SetNumUninitialized(NumStats);
+	SumValues.SetNumUninitialized(NumStats);
+	SumTargets.SetNumUninitialized(NumStats);
+	SumSquaredValues.SetNumUninitialized(NumStats);
+	SumSquaredTargets.SetNumUninitialized(NumStats);
+	SumProducts.SetNumUninitialized(NumStats);
+
+	SetTarget(TargetName);
+}
+
+void FQuickStatsCorrelation::SetTarget(const FString& InTargetName)
+{
+	TargetName = InTargetName;
+	TargetIndex = INDEX_NONE;
+	if (!TargetName.IsEmpty() && TargetName != TEXT("FrameTime"))
+	{
+		TargetIndex = StatNames.IndexOfByKey(TargetName);
+		if (TargetIndex == INDEX_NONE && NumStats > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Correlation target %s is not evaluated, using frame time"), *TargetName);
+		}
+	}
+
+	ResetWindow();
+}
+
+void FQuickStatsCorrelation::ResetWindow()
+{
+	RingHead = 0;
+	NumFramesInWindow = 0;
+	NumFramesSinceRecompute = 0;
+
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		Counts[StatIndex] = SumValues[StatIndex] = SumTargets[StatIndex] = 0.;
+		SumSquaredValues[StatIndex] = SumSquaredTargets[StatIndex] = SumProducts[StatIndex] = 0.;
+	}
+}
+
+void FQuickStatsCorrelation::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (Values.Num() != NumStats || NumStats == 0)
+	{
+		return;
+	}
+
+	const double Target = (TargetIndex == INDEX_NONE) ? FrameDuration : Values[TargetIndex];
+
+	if (FMath::IsNaN(Target))
+	{
+		return;
+	}
+
+	if (NumFramesInWindow == 0)
+	{
+		TargetShift = Target;
+	}
+	const double ShiftedTarget = Target - TargetShift;
+
+	double* RESTRICT CountsData = Counts.GetData();
+	double* RESTRICT SumValuesData = SumValues.GetData();
+	double* RESTRICT SumTargetsData = SumTargets.GetData();
+	double* RESTRICT SumSquaredValuesData = SumSquaredValues.GetData();
+	double* RESTRICT SumSquaredTargetsData = SumSquaredTargets.GetData();
+	double* RESTRICT SumProductsData = SumProducts.GetData();
+
+	// oldest frame leaves the window, its slot is reused for the new frame
+	double* RESTRICT SlotValues = RingValues.GetData() + RingHead * NumStats;
+	double* RESTRICT SlotValidity = RingValidity.GetData() + RingHead * NumStats;
+	if (NumFramesInWindow == WindowSize)
+	{
+		const double OldTarget = RingTargets[RingHead];
+		for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+		{
+			const double Validity = SlotValidity[StatIndex];
+			const double Value = SlotValues[StatIndex];
+			CountsData[StatIndex] -= Validity;
+			SumValuesData[StatIndex] -= Value;
+			SumTargetsData[StatIndex] -= Validity * OldTarget;
+			SumSquaredValuesData[StatIndex] -= Value * Value;
+			SumSquaredTargetsData[StatIndex] -= Validity * OldTarget * OldTarget;
+			SumProductsData[StatIndex] -= Value * OldTarget;
+		}
+	}
+	else
+	{
+		NumFramesInWindow++;
+	}
+
+	// stats without samples in the window take their shift from this frame
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		if (CountsData[StatIndex] <= 0. && !FMath::IsNaN(Values[StatIndex]))
+		{
+			Shifts[StatIndex] = Values[StatIndex];
+		}
+	}
+
+	const double* RESTRICT ShiftsData = Shifts.GetData();
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		const double RawValue = Values[StatIndex];
+		const bool bIsValid = (RawValue == RawValue);
+		const double Validity = bIsValid ? 1. : 0.;
+		const double Value = bIsValid ? RawValue - ShiftsData[StatIndex] : 0.;
+
+		SlotValues[StatIndex] = Value;
+		SlotValidity[StatIndex] = Validity;
+
+		CountsData[StatIndex] += Validity;
+		SumValuesData[StatIndex] += Value;
+		SumTargetsData[StatIndex] += Validity * ShiftedTarget;
+		SumSquaredValuesData[StatIndex] += Value * Value;
+		SumSquaredTargetsData[StatIndex] += Validity * ShiftedTarget * ShiftedTarget;
+		SumProductsData[StatIndex] += Value * ShiftedTarget;
+	}
+	RingTargets[RingHead] = ShiftedTarget;
+	RingHead = (RingHead + 1) % WindowSize;
+
+	// recomputing once per window keeps the amortized cost per frame the same
+	if (++NumFramesSinceRecompute >= WindowSize)
+	{
+		RecomputeSums();
+	}
+}
+
+void FQuickStatsCorrelation::RecomputeSums()
+{
+	NumFramesSinceRecompute = 0;
+
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		Counts[StatIndex] = SumValues[StatIndex] = SumTargets[StatIndex] = 0.;
+		SumSquaredValues[StatIndex] = SumSquaredTargets[StatIndex] = SumProducts[StatIndex] = 0.;
+	}
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFramesInWindow; ++FrameIndex)
+	{
+		const double Target = RingTargets[FrameIndex];
+		const double* RESTRICT FrameValues = RingValues.GetData() + FrameIndex * NumStats;
+		const double* RESTRICT FrameValidity = RingValidity.GetData() + FrameIndex * NumStats;
+		for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+		{
+			const double Validity = FrameValidity[StatIndex];
+			const double Value = FrameValues[StatIndex];
+			Counts[StatIndex] += Validity;
+			SumValues[StatIndex] += Value;
+			SumTargets[StatIndex] += Validity * Target;
+			SumSquaredValues[StatIndex] += Value * Value;
+			SumSquaredTargets[StatIndex] += Validity * Target * Target;
+			SumProducts[StatIndex] += Value * Target;
+		}
+	}
+}
+
+bool FQuickStatsCorrelation::GetCorrelation(int32 StatIndex, double& OutCorrelation, double& OutSlope) const
+{
+	if (StatIndex < 0 || StatIndex >= NumStats)
+	{
+		return false;
+	}
+
+	const double Count = Counts[StatIndex];
+	if (StatIndex == TargetIndex || Count < 2.)
+	{
+		return false;
+	}
+
+	const double Covariance = SumProducts[StatIndex] - SumValues[StatIndex] * SumTargets[StatIndex] / Count;
+	const double ValueVariance = SumSquaredValues[StatIndex] - SumValues[StatIndex] * SumValues[StatIndex] / Count;
+	const double TargetVariance = SumSquaredTargets[StatIndex] - SumTargets[StatIndex] * SumTargets[StatIndex] / Count;
+
+	// constant stats can't explain anything, variance lost to rounding counts as constant
+	if (ValueVariance <= RelativeEpsilon * SumSquaredValues[StatIndex] || TargetVariance <= RelativeEpsilon * SumSquaredTargets[StatIndex])
+	{
+		return false;
+	}
+
+	OutCorrelation = Covariance / FMath::Sqrt(ValueVariance * TargetVariance);
+	OutSlope = Covariance / ValueVariance;
+	return true;
+}
+
+void FQuickStatsCorrelation::LogTopContributors(int32 NumContributors) const
+{
+	struct FContributor
+	{
+		int32 StatIndex;
+		double Correlation;
+		// change of the target per unit of the stat
+		double Slope;
+	};
+
+	TArray<FContributor> Contributors;
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		FContributor Contributor = { StatIndex, 0., 0. };
+		if (GetCorrelation(StatIndex, Contributor.Correlation, Contributor.Slope))
+		{
+			Contributors.Add(Contributor);
+		}
+	}
+
+	Contributors.Sort([](const FContributor& A, const FContributor& B) { return FMath::Abs(A.Correlation) > FMath::Abs(B.Correlation); });
+
+	const FString Target = (TargetIndex == INDEX_NONE) ? FString(TEXT("FrameTime")) : StatNames[TargetIndex];
+	UE_LOG(LogTemp, Display, TEXT("[QuickStat] Correlation with %s over %d frames:"), *Target, NumFramesInWindow);
+	for (int32 Index = 0; Index < FMath::Min(NumContributors, Contributors.Num()); ++Index)
+	{
+		const FContributor& Contributor = Contributors[Index];
+		UE_LOG(LogTemp, Display, TEXT("[QuickStat]   r=%+.3f  slope=%+.4g  %s"), Contributor.Correlation, Contributor.Slope, *StatNames[Contributor.StatIndex]);
+	}
+}
+
+#endif //#if STATS
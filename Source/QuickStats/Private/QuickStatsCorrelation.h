@@ -0,0 +1,69 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+
+/*
+* Correlation of every evaluated stat with a target stat (frame time by default) over a sliding window of frames.
+* Sums are updated as frames enter and leave the window, so each frame costs O(number of stats) regardless of the window size.
+*/
+class FQuickStatsCorrelation : public IQuickStatsFeed
+{
+public:
+	FQuickStatsCorrelation(int32 InWindowSize, const FString& InTargetName);
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+	// "Preset/Stat description", empty or FrameTime correlates with frame time, window restarts
+	void SetTarget(const FString& InTargetName);
+
+	// correlation of a stat with the target over the window and change of the target per unit of the stat,
+	// false if the stat is the target or it or the target is constant
+	bool GetCorrelation(int32 StatIndex, double& OutCorrelation, double& OutSlope) const;
+
+	// logs stats most correlated with the target
+	void LogTopContributors(int32 NumContributors) const;
+
+private:
+	void ResetWindow();
+	// recomputes the sums from the frames in the window, so rounding errors of add/remove don't accumulate
+	void RecomputeSums();
+
+private:
+	int32 WindowSize = 0;
+	FString TargetName;
+	// INDEX_NONE correlates with frame time
+	int32 TargetIndex = INDEX_NONE;
+
+	TArray<FString> StatNames;
+	int32 NumStats = 0;
+
+	// ring of WindowSize frames, NumStats values each
+	// values are stored shifted, invalid values are stored as 0 with 0 validity so updates don't branch
+	TArray<double> RingValues;
+	TArray<double> RingValidity;
+	TArray<double> RingTargets;
+	int32 RingHead = 0;
+	int32 NumFramesInWindow = 0;
+	int32 NumFramesSinceRecompute = 0;
+
+	// values are shifted by their first sample to keep the sums well conditioned
+	TArray<double> Shifts;
+	double TargetShift = 0.;
+
+	// per stat sums over frames where both the stat and the target are valid
+	TArray<double> Counts;
+	TArray<double> SumValues;
+	TArray<double> SumTargets;
+	TArray<double> SumSquaredValues;
+	TArray<double> SumSquaredTargets;
+	TArray<double> SumProducts;
+};
+
+#endif //#if STATS
@@ -0,0 +1,55 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsCsvFeed.h"
+
+#if QUICKSTATS_CSV_ENABLED
+
+CSV_DEFINE_CATEGORY(QuickStats, true);
+
+bool FQuickStatsCsvFeed::IsActive() const
+{
+	return NumCsvStats > 0 && FCsvProfiler::Get()->IsCapturing();
+}
+
+bool FQuickStatsCsvFeed::IsStatRequired(int32 StatIndex) const
+{
+	return CsvStatNames.IsValidIndex(StatIndex) && !CsvStatNames[StatIndex].IsNone();
+}
+
+void FQuickStatsCsvFeed::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	CsvStatNames.Reset(Stats.Num());
+	NumCsvStats = 0;
+
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		FName CsvStatName = NAME_None;
+		if (Stat.bRecordToCsv)
+		{
+			// commas would break the CSV columns, slashes are used for categories by the report tools
+			FString StatName = Stat.PresetName.ToString() + TEXT("_") + Stat.StatDescription;
+			StatName.ReplaceCharInline(TEXT(','), TEXT('_'));
+			StatName.ReplaceCharInline(TEXT('/'), TEXT('_'));
+			StatName.ReplaceCharInline(TEXT(' '), TEXT('_'));
+
+			CsvStatName = FName(*StatName);
+			NumCsvStats++;
+		}
+		CsvStatNames.Add(CsvStatName);
+	}
+}
+
+void FQuickStatsCsvFeed::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	const int32 NumValues = FMath::Min(Values.Num(), CsvStatNames.Num());
+	for (int32 ValueIndex = 0; ValueIndex < NumValues; ++ValueIndex)
+	{
+		const double Value = Values[ValueIndex];
+		if (!CsvStatNames[ValueIndex].IsNone() && !FMath::IsNaN(Value))
+		{
+			FCsvProfiler::RecordCustomStat(CsvStatNames[ValueIndex], CSV_CATEGORY_INDEX(QuickStats), (float)Value, ECsvCustomStatOp::Set);
+		}
+	}
+}
+
+#endif //#if QUICKSTATS_CSV_ENABLED
@@ -0,0 +1,32 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#define QUICKSTATS_CSV_ENABLED (STATS && CSV_PROFILER)
+
+#if QUICKSTATS_CSV_ENABLED
+
+#include "QuickStatsFeed.h"
+
+/*
+* Records stats of presets marked with RecordToCsv as custom stats in the QuickStats category of CSV profiler captures.
+* Only active while a capture is running, other presets are not evaluated for it.
+*/
+class FQuickStatsCsvFeed : public IQuickStatsFeed
+{
+public:
+	virtual bool IsActive() const override;
+	virtual bool IsStatRequired(int32 StatIndex) const override;
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+private:
+	// NAME_None for stats not recorded to CSV
+	TArray<FName> CsvStatNames;
+	int32 NumCsvStats = 0;
+};
+
+#endif //#if QUICKSTATS_CSV_ENABLED
@@ -0,0 +1,55 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+struct FQuickStatEvaluationContext;
+
+struct FQuickStatsFeedStat
+{
+	FName PresetName = NAME_None;
+	FString StatDescription;
+	double Budget = 0.;
+	// preset is marked for CSV captures
+	bool bRecordToCsv = false;
+	// code stats read by the stat expression
+	TArray<FName> RequiredStatNames;
+
+	bool operator==(const FQuickStatsFeedStat& Other) const
+	{
+		return PresetName == Other.PresetName && StatDescription.Equals(Other.StatDescription, ESearchCase::CaseSensitive) && Budget == Other.Budget
+			&& bRecordToCsv == Other.bRecordToCsv && RequiredStatNames == Other.RequiredStatNames;
+	}
+	bool operator!=(const FQuickStatsFeedStat& Other) const { return !(*this == Other); }
+};
+
+/*
+* Receives values of all the stats evaluated by QuickStats, independent of pages and refresh rate.
+* Feeds are called on the game thread and should defer any expensive work.
+*/
+class IQuickStatsFeed
+{
+public:
+	virtual ~IQuickStatsFeed() = default;
+
+	// Stats are only evaluated for the feeds if at least one of them is active.
+	virtual bool IsActive() const { return true; }
+
+	// Feeds can limit the stats evaluated for them, values of other stats might be NaN.
+	virtual bool IsStatRequired(int32 StatIndex) const { return true; }
+
+	// Stats to evaluate changed, values passed to OnStatsEvaluated are in the same order.
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) = 0;
+
+	// Raw stats evaluated values are computed from, called before OnStatsEvaluated.
+	virtual void OnRawStatsAvailable(const FQuickStatEvaluationContext& Context) {}
+
+	// Time is when the frame was collected (seconds), FrameDuration is the frame time of that frame (ms), NaN if unknown.
+	// Values of stats that couldn't be evaluated are NaN.
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) = 0;
+};
+
+#endif //#if STATS
@@ -0,0 +1,230 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsHeatmap.h"
+
+#if STATS
+
+#include "Async/Async.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+// larger maps only get the CSV
+static constexpr int32 MaxImageSize = 4096;
+
+FQuickStatsHeatmap::FQuickStatsHeatmap(float InCellSize, bool bInIncludeHeight)
+	: CellSize(FMath::Max(InCellSize, 1.f))
+	, bIncludeHeight(bInIncludeHeight)
+{
+	Grid.CellSize = CellSize;
+}
+
+FQuickStatsHeatmap::~FQuickStatsHeatmap()
+{
+	Export();
+
+	for (TFuture<void>& PendingWrite : PendingWrites)
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void FQuickStatsHeatmap::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	// cells store stats by index, they can't be kept when the stats change
+	Export();
+
+	Grid = FGrid();
+	Grid.CellSize = CellSize;
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		Grid.PresetNames.Add(Stat.PresetName);
+		Grid.StatDescriptions.Add(Stat.StatDescription);
+		Grid.Budgets.Add(Stat.Budget);
+	}
+	NumStats = Stats.Num();
+	CellIndices.Reset();
+	ViewCellIndex = INDEX_NONE;
+}
+
+void FQuickStatsHeatmap::SetViewLocation(const FVector& Location)
+{
+	const FIntVector Cell(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), bIncludeHeight ? FMath::FloorToInt(Location.Z / CellSize) : 0);
+	if (!bHasViewLocation || Cell != ViewCell)
+	{
+		ViewCell = Cell;
+		ViewCellIndex = INDEX_NONE;
+	}
+	bHasViewLocation = true;
+}
+
+void FQuickStatsHeatmap::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (!bHasViewLocation || Values.Num() != NumStats || NumStats == 0)
+	{
+		return;
+	}
+
+	if (ViewCellIndex == INDEX_NONE)
+	{
+		const int32* CellIndex = CellIndices.Find(ViewCell);
+		if (CellIndex)
+		{
+			ViewCellIndex = *CellIndex;
+		}
+		else
+		{
+			ViewCellIndex = Grid.CellCoordinates.Add(ViewCell);
+			Grid.CellFrames.Add(0);
+			Grid.CellStats.AddDefaulted(NumStats);
+			CellIndices.Add(ViewCell, ViewCellIndex);
+		}
+	}
+
+	Grid.CellFrames[ViewCellIndex]++;
+
+	FCellStat* CellStats = Grid.CellStats.GetData() + ViewCellIndex * NumStats;
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		const double Value = Values[StatIndex];
+		if (!FMath::IsNaN(Value))
+		{
+			FCellStat& CellStat = CellStats[StatIndex];
+			CellStat.Max = (CellStat.NumValues > 0) ? FMath::Max(CellStat.Max, Value) : Value;
+			CellStat.Sum += Value;
+			CellStat.NumValues++;
+		}
+	}
+}
+
+void FQuickStatsHeatmap::Export()
+{
+	if (Grid.CellCoordinates.Num() == 0)
+	{
+		return;
+	}
+
+	const FString Directory = FPaths::ProjectSavedDir() / TEXT("QuickStats") / TEXT("Heatmaps") / FString::Printf(TEXT("Heatmap_%s"), *FDateTime::Now().ToString(TEXT("%Y.%m.%d-%H.%M.%S.%s")));
+
+	// image wrapper module can only be loaded on the game thread
+	TArray<TSharedPtr<IImageWrapper>> ImageWrappers;
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		ImageWrappers.Add(ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG));
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] Writing heatmap of %d cells to %s"), Grid.CellCoordinates.Num(), *Directory);
+
+	PendingWrites.RemoveAll([](const TFuture<void>& PendingWrite) { return PendingWrite.IsReady(); });
+	PendingWrites.Add(Async(EAsyncExecution::ThreadPool, [ExportedGrid = Grid, Directory, ImageWrappers = MoveTemp(ImageWrappers)]() { WriteGrid(ExportedGrid, Directory, ImageWrappers); }));
+}
+
+void FQuickStatsHeatmap::WriteGrid(const FGrid& Grid, const FString& Directory, const TArray<TSharedPtr<IImageWrapper>>& ImageWrappers)
+{
+	const int32 NumCells = Grid.CellCoordinates.Num();
+	const int32 NumStats = Grid.StatDescriptions.Num();
+
+	// one row per cell and stat, world position is the center of the cell
+	FString Csv;
+	Csv.Reserve(NumCells * NumStats * 64);
+	Csv += TEXT("Preset,Stat,CellX,CellY,CellZ,X,Y,Z,Frames,Mean,Max,Budget\n");
+
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		const FString StatColumns = FString::Printf(TEXT("%s,\"%s\""), *Grid.PresetNames[StatIndex].ToString(), *Grid.StatDescriptions[StatIndex].Replace(TEXT("\""), TEXT("\"\"")));
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			const FCellStat& CellStat = Grid.CellStats[CellIndex * NumStats + StatIndex];
+			if (CellStat.NumValues > 0)
+			{
+				const FIntVector& Cell = Grid.CellCoordinates[CellIndex];
+				const FVector Center = (FVector(Cell.X, Cell.Y, Cell.Z) + 0.5f) * Grid.CellSize;
+				Csv += FString::Printf(TEXT("%s,%d,%d,%d,%.0f,%.0f,%.0f,%d,%.4f,%.4f,%.4f\n"), *StatColumns, Cell.X, Cell.Y, Cell.Z, Center.X, Center.Y, Center.Z,
+					Grid.CellFrames[CellIndex], CellStat.Sum / CellStat.NumValues, CellStat.Max, Grid.Budgets[StatIndex]);
+			}
+		}
+	}
+
+	const FString CsvPath = Directory / TEXT("Heatmap.csv");
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write heatmap %s"), *CsvPath);
+		return;
+	}
+
+	// top down images, one pixel per cell with X to the right and Y down
+	FIntPoint MinCell(MAX_int32, MAX_int32);
+	FIntPoint MaxCell(MIN_int32, MIN_int32);
+	for (const FIntVector& Cell : Grid.CellCoordinates)
+	{
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+	}
+
+	const int64 Width = static_cast<int64>(MaxCell.X) - MinCell.X + 1;
+	const int64 Height = static_cast<int64>(MaxCell.Y) - MinCell.Y + 1;
+	if (Width > MaxImageSize || Height > MaxImageSize)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Heatmap is %lldx%lld cells, images are skipped, increase HeatmapCellSize"), Width, Height);
+		return;
+	}
+
+	TArray<double> PixelValues;
+	TArray<FColor> Pixels;
+	for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+	{
+		// cells at different heights are combined by their max
+		PixelValues.Init(std::numeric_limits<double>::quiet_NaN(), Width * Height);
+		double MaxValue = 0.;
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			const FCellStat& CellStat = Grid.CellStats[CellIndex * NumStats + StatIndex];
+			if (CellStat.NumValues > 0)
+			{
+				const FIntVector& Cell = Grid.CellCoordinates[CellIndex];
+				double& PixelValue = PixelValues[(Cell.Y - MinCell.Y) * Width + (Cell.X - MinCell.X)];
+				PixelValue = FMath::IsNaN(PixelValue) ? CellStat.Max : FMath::Max(PixelValue, CellStat.Max);
+				MaxValue = FMath::Max(MaxValue, CellStat.Max);
+			}
+		}
+
+		// budgeted stats use the overlay colors, others a blue to red gradient up to their max
+		const double Budget = Grid.Budgets[StatIndex];
+		Pixels.Init(FColor::Transparent, Width * Height);
+		for (int32 PixelIndex = 0; PixelIndex < PixelValues.Num(); ++PixelIndex)
+		{
+			const double Value = PixelValues[PixelIndex];
+			if (FMath::IsNaN(Value))
+			{
+				continue;
+			}
+
+			if (Budget > 0.)
+			{
+				Pixels[PixelIndex] = (Value > Budget) ? FColor::Red : (Value > Budget * 0.75) ? FColor::Yellow : FColor::Green;
+			}
+			else
+			{
+				const float Alpha = (MaxValue > 0.) ? FMath::Clamp(static_cast<float>(Value / MaxValue), 0.f, 1.f) : 0.f;
+				Pixels[PixelIndex] = FLinearColor::MakeFromHSV8(static_cast<uint8>((1.f - Alpha) * 170.f), 255, 255).ToFColor(true);
+			}
+		}
+
+		const TSharedPtr<IImageWrapper>& ImageWrapper = ImageWrappers[StatIndex];
+		if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+		{
+			continue;
+		}
+
+		const FString ImagePath = Directory / FPaths::MakeValidFileName(Grid.PresetNames[StatIndex].ToString() + TEXT("_") + Grid.StatDescriptions[StatIndex], TEXT('_')) + TEXT(".png");
+		if (!FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *ImagePath))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write heatmap image %s"), *ImagePath);
+		}
+	}
+}
+
+#endif //#if STATS
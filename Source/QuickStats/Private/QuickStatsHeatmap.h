@@ -0,0 +1,74 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+#include "Async/Future.h"
+
+class IImageWrapper;
+
+/*
+* Bins evaluated stats by camera position into a sparse grid of cells, keeping mean and max of every stat per cell.
+* Exported to Saved/QuickStats/Heatmaps as a CSV of all the cells and a top down PNG per stat, when the schema changes,
+* with qstats.ExportHeatmap and when the feed is destroyed.
+*/
+class FQuickStatsHeatmap : public IQuickStatsFeed
+{
+public:
+	// cells are CellSize cm wide, only X and Y are binned unless bIncludeHeight
+	FQuickStatsHeatmap(float InCellSize, bool bInIncludeHeight);
+	virtual ~FQuickStatsHeatmap();
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+	// location evaluated frames are binned at until it's set again
+	void SetViewLocation(const FVector& Location);
+
+	// hands the grid over to a worker thread, recording continues into the same grid
+	void Export();
+
+private:
+	struct FCellStat
+	{
+		double Sum = 0.;
+		double Max = 0.;
+		int32 NumValues = 0;
+	};
+
+	struct FGrid
+	{
+		float CellSize = 0.f;
+		TArray<FName> PresetNames;
+		TArray<FString> StatDescriptions;
+		TArray<double> Budgets;
+
+		TArray<FIntVector> CellCoordinates;
+		TArray<int32> CellFrames;
+		// NumCells * NumStats
+		TArray<FCellStat> CellStats;
+	};
+
+	static void WriteGrid(const FGrid& Grid, const FString& Directory, const TArray<TSharedPtr<IImageWrapper>>& ImageWrappers);
+
+private:
+	float CellSize = 0.f;
+	bool bIncludeHeight = false;
+
+	FGrid Grid;
+	int32 NumStats = 0;
+	TMap<FIntVector, int32> CellIndices;
+
+	bool bHasViewLocation = false;
+	FIntVector ViewCell = FIntVector::ZeroValue;
+	// camera usually stays in the same cell for many frames, the map lookup is skipped then
+	int32 ViewCellIndex = INDEX_NONE;
+
+	TArray<TFuture<void>> PendingWrites;
+};
+
+#endif //#if STATS
@@ -0,0 +1,218 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsHitchCapture.h"
+
+#if STATS
+
+#include "QuickStatSettings.h"
+#include "QuickStatExpressions.h"
+#include "Async/Async.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FQuickStatsHitchCapture::FQuickStatsHitchCapture(const UQuickStatSettings& Settings)
+	: FrameTimeThreshold(Settings.HitchFrameTimeThreshold)
+	, bCaptureOverBudget(Settings.HitchOnOverBudget)
+	, PreRollFrames(FMath::Max(Settings.HitchPreRollFrames, 0))
+	, PostRollFrames(FMath::Max(Settings.HitchPostRollFrames, 0))
+	, Cooldown(Settings.HitchCooldown)
+{
+}
+
+FQuickStatsHitchCapture::~FQuickStatsHitchCapture()
+{
+	for (TFuture<void>& PendingWrite : PendingWrites)
+	{
+		PendingWrite.Wait();
+	}
+}
+
+void FQuickStatsHitchCapture::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	// ring layout is about to change, write what we have
+	if (HitchFrameIndex != INDEX_NONE)
+	{
+		DumpSnapshot();
+	}
+
+	NumStats = Stats.Num();
+	ColumnNames.Reset();
+	RawStatNames.Reset();
+	Budgets.Reset(NumStats);
+
+	ColumnNames.Add(TEXT("FrameTime(ms)"));
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		ColumnNames.Add(Stat.PresetName.ToString() + TEXT("/") + Stat.StatDescription);
+		Budgets.Add(Stat.Budget);
+
+		for (FName StatName : Stat.RequiredStatNames)
+		{
+			RawStatNames.AddUnique(StatName);
+		}
+	}
+	for (FName StatName : RawStatNames)
+	{
+		ColumnNames.Add(StatName.ToString());
+	}
+
+	// all the memory needed for recording is allocated here, recording a frame is just a copy
+	RingCapacity = PreRollFrames + PostRollFrames + 1;
+	RingFrameNumbers.SetNumZeroed(RingCapacity);
+	RingTimes.SetNumZeroed(RingCapacity);
+	RingValues.SetNumZeroed(RingCapacity * ColumnNames.Num());
+
+	NumRecordedFrames = 0;
+	HitchFrameIndex = INDEX_NONE;
+}
+
+double* FQuickStatsHitchCapture::GetFrameValues(int64 FrameIndex)
+{
+	return RingValues.GetData() + (FrameIndex % RingCapacity) * ColumnNames.Num();
+}
+
+void FQuickStatsHitchCapture::OnRawStatsAvailable(const FQuickStatEvaluationContext& Context)
+{
+	if (RingCapacity == 0)
+	{
+		return;
+	}
+
+	double* RawValues = GetFrameValues(NumRecordedFrames) + 1 + NumStats;
+	for (int32 RawStatIndex = 0; RawStatIndex < RawStatNames.Num(); ++RawStatIndex)
+	{
+		if (!UQuickStatExpressionReadStat::ReadStatValue(Context, RawStatNames[RawStatIndex], RawValues[RawStatIndex]))
+		{
+			RawValues[RawStatIndex] = std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+}
+
+void FQuickStatsHitchCapture::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (RingCapacity == 0 || Values.Num() != NumStats)
+	{
+		return;
+	}
+
+	const int64 FrameIndex = NumRecordedFrames++;
+
+	RingFrameNumbers[FrameIndex % RingCapacity] = FrameNumber;
+	RingTimes[FrameIndex % RingCapacity] = Time;
+
+	double* FrameValues = GetFrameValues(FrameIndex);
+	FrameValues[0] = FrameDuration;
+	FMemory::Memcpy(FrameValues + 1, Values.GetData(), NumStats * sizeof(double));
+
+	if (HitchFrameIndex == INDEX_NONE && (Time - LastHitchTime) >= Cooldown)
+	{
+		FString Reason = FindHitchReason(Values, FrameDuration);
+		if (!Reason.IsEmpty())
+		{
+			HitchFrameIndex = FrameIndex;
+			HitchReason = MoveTemp(Reason);
+			LastHitchTime = Time;
+		}
+	}
+
+	if (HitchFrameIndex != INDEX_NONE && (FrameIndex - HitchFrameIndex) >= PostRollFrames)
+	{
+		DumpSnapshot();
+	}
+}
+
+FString FQuickStatsHitchCapture::FindHitchReason(TArrayView<const double> Values, double FrameTime) const
+{
+	if (FrameTimeThreshold > 0.f && FrameTime > FrameTimeThreshold)
+	{
+		return FString::Printf(TEXT("FrameTime %.2fms > %.2fms"), FrameTime, FrameTimeThreshold);
+	}
+
+	if (bCaptureOverBudget)
+	{
+		for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+		{
+			// NaN never compares greater, invalid stats can't trigger a capture
+			if (Budgets[StatIndex] > 0. && Values[StatIndex] > Budgets[StatIndex])
+			{
+				return FString::Printf(TEXT("%s %.2f > %.2f"), *ColumnNames[StatIndex + 1], Values[StatIndex], Budgets[StatIndex]);
+			}
+		}
+	}
+
+	return FString();
+}
+
+void FQuickStatsHitchCapture::DumpSnapshot()
+{
+	const uint64 HitchFrameNumber = RingFrameNumbers[HitchFrameIndex % RingCapacity];
+	const double HitchTime = RingTimes[HitchFrameIndex % RingCapacity];
+
+	FSnapshot Snapshot;
+	Snapshot.FilePath = FPaths::ProjectSavedDir() / TEXT("QuickStats") / TEXT("Hitches") / FString::Printf(TEXT("Hitch_%s_%llu.csv"), *FDateTime::Now().ToString(), HitchFrameNumber);
+	Snapshot.Reason = MoveTemp(HitchReason);
+	Snapshot.HitchFrameNumber = HitchFrameNumber;
+	Snapshot.ColumnNames = ColumnNames;
+
+	// oldest frame still in the ring
+	const int64 FirstFrameIndex = FMath::Max<int64>(NumRecordedFrames - RingCapacity, 0);
+	const int32 NumFrames = NumRecordedFrames - FirstFrameIndex;
+	Snapshot.FrameNumbers.Reserve(NumFrames);
+	Snapshot.Times.Reserve(NumFrames);
+	Snapshot.Values.Reserve(NumFrames * ColumnNames.Num());
+	for (int64 FrameIndex = FirstFrameIndex; FrameIndex < NumRecordedFrames; ++FrameIndex)
+	{
+		Snapshot.FrameNumbers.Add(RingFrameNumbers[FrameIndex % RingCapacity]);
+		Snapshot.Times.Add(RingTimes[FrameIndex % RingCapacity] - HitchTime);
+		Snapshot.Values.Append(GetFrameValues(FrameIndex), ColumnNames.Num());
+	}
+
+	HitchFrameIndex = INDEX_NONE;
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] Hitch at frame %llu (%s), writing %s"), HitchFrameNumber, *Snapshot.Reason, *Snapshot.FilePath);
+
+	PendingWrites.RemoveAll([](const TFuture<void>& PendingWrite) { return PendingWrite.IsReady(); });
+	PendingWrites.Add(Async(EAsyncExecution::ThreadPool, [Snapshot = MoveTemp(Snapshot)]() { WriteSnapshot(Snapshot); }));
+}
+
+void FQuickStatsHitchCapture::WriteSnapshot(const FSnapshot& Snapshot)
+{
+	const int32 NumColumns = Snapshot.ColumnNames.Num();
+
+	FString Csv;
+	Csv.Reserve(Snapshot.FrameNumbers.Num() * NumColumns * 12);
+
+	Csv += FString::Printf(TEXT("# %s at frame %llu\n"), *Snapshot.Reason, Snapshot.HitchFrameNumber);
+	Csv += TEXT("Frame,Time");
+	for (const FString& ColumnName : Snapshot.ColumnNames)
+	{
+		Csv += FString::Printf(TEXT(",\"%s\""), *ColumnName.Replace(TEXT("\""), TEXT("\"\"")));
+	}
+	Csv += TEXT("\n");
+
+	for (int32 FrameIndex = 0; FrameIndex < Snapshot.FrameNumbers.Num(); ++FrameIndex)
+	{
+		Csv += FString::Printf(TEXT("%llu,%.4f"), Snapshot.FrameNumbers[FrameIndex], Snapshot.Times[FrameIndex]);
+
+		const double* FrameValues = Snapshot.Values.GetData() + FrameIndex * NumColumns;
+		for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+		{
+			if (FMath::IsNaN(FrameValues[ColumnIndex]))
+			{
+				Csv += TEXT(",");
+			}
+			else
+			{
+				Csv += FString::Printf(TEXT(",%.4f"), FrameValues[ColumnIndex]);
+			}
+		}
+		Csv += TEXT("\n");
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Snapshot.FilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write hitch capture %s"), *Snapshot.FilePath);
+	}
+}
+
+#endif //#if STATS
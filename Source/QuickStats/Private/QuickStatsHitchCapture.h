@@ -0,0 +1,76 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+#include "Async/Future.h"
+
+class UQuickStatSettings;
+
+/*
+* Records evaluated stats, the raw stats they read and the frame time into a preallocated ring.
+* When frame time crosses the threshold or a stat goes over budget, the pre-roll and post-roll frames are written
+* to Saved/QuickStats/Hitches as CSV on a worker thread.
+*/
+class FQuickStatsHitchCapture : public IQuickStatsFeed
+{
+public:
+	FQuickStatsHitchCapture(const UQuickStatSettings& Settings);
+	virtual ~FQuickStatsHitchCapture();
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnRawStatsAvailable(const FQuickStatEvaluationContext& Context) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+private:
+	struct FSnapshot
+	{
+		FString FilePath;
+		FString Reason;
+		uint64 HitchFrameNumber = 0;
+		TArray<FString> ColumnNames;
+		TArray<uint64> FrameNumbers;
+		TArray<double> Times;
+		// NumFrames * NumColumns
+		TArray<double> Values;
+	};
+
+	double* GetFrameValues(int64 FrameIndex);
+	// returns empty string if the frame is not a hitch
+	FString FindHitchReason(TArrayView<const double> Values, double FrameTime) const;
+	void DumpSnapshot();
+	static void WriteSnapshot(const FSnapshot& Snapshot);
+
+private:
+	float FrameTimeThreshold = 0.f;
+	bool bCaptureOverBudget = false;
+	int32 PreRollFrames = 0;
+	int32 PostRollFrames = 0;
+	double Cooldown = 0.;
+
+	// frame time, evaluated stats and raw stats
+	TArray<FString> ColumnNames;
+	TArray<FName> RawStatNames;
+	TArray<double> Budgets;
+	int32 NumStats = 0;
+
+	// ring of PreRollFrames + PostRollFrames + 1 frames, allocated when the schema changes
+	int32 RingCapacity = 0;
+	TArray<uint64> RingFrameNumbers;
+	TArray<double> RingTimes;
+	TArray<double> RingValues;
+	int64 NumRecordedFrames = 0;
+
+	// frame index of the hitch being captured, INDEX_NONE if not capturing
+	int64 HitchFrameIndex = INDEX_NONE;
+	FString HitchReason;
+	double LastHitchTime = -DBL_MAX;
+
+	TArray<TFuture<void>> PendingWrites;
+};
+
+#endif //#if STATS
@@ -5,25 +5,96 @@
 #if STATS
 
 #include "QuickStatSettings.h"
+#include "SQuickStatsOverlay.h"
+#include "QuickStatsSharedMemoryFeed.h"
+#include "QuickStatsStreamingFeed.h"
+#include "QuickStatsTraceFeed.h"
+#include "QuickStatsCsvFeed.h"
+#include "QuickStatsHitchCapture.h"
+#include "QuickStatsCaptureFeed.h"
+#include "QuickStatsCorrelation.h"
+#include "QuickStatsHeatmap.h"
+#include "QuickStatsCollector.h"
+#include "QuickStatsSessionReport.h"
+#include "QuickStatsBaseline.h"
 #include "String/ParseTokens.h"
 #include "Stats/StatsData.h"
 
+#include "Misc/App.h"
 #include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Misc/CoreDelegates.h"
 #include "Engine/Console.h"
 #include "Engine/Engine.h"
 #include "Engine/Canvas.h"
+#include "CanvasItem.h"
+#include "CanvasTypes.h"
+#include "RenderUtils.h"
 #include "Engine/Font.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/UserInterfaceSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "RHI.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#include "EditorViewportClient.h"
+#endif
 
-bool			FQuickStatsRenderer::bIsRenderingStats = false;
 TArray<FName>	FQuickStatsRenderer::EnabledPresets;
-TSet<FName>		FQuickStatsRenderer::EnabledStatGroups;
+TUniquePtr<FQuickStatsCollector> FQuickStatsRenderer::StatsCollector;
+TMap<const FViewportClient*, FQuickStatsRenderer::FViewState> FQuickStatsRenderer::ViewStates;
+bool			FQuickStatsRenderer::bStatStatesDirty = true;
+uint64			FQuickStatsRenderer::LastEvaluatedFrameNumber = 0;
+TArray<FQuickStatsRenderer::FPresetState> FQuickStatsRenderer::PresetStates;
+TArray<FQuickStatsRenderer::FStatState> FQuickStatsRenderer::StatStates;
+TArray<int32>	FQuickStatsRenderer::EveryFrameStatIndices;
+TArray<FQuickStatsRenderer::FScheduledSample> FQuickStatsRenderer::SampleSchedule;
+TArray<TUniquePtr<IQuickStatsFeed>> FQuickStatsRenderer::Feeds;
+TArray<double>	FQuickStatsRenderer::FeedValues;
+TArray<IQuickStatsFeed*> FQuickStatsRenderer::ActiveFeeds;
+TArray<FQuickStatsFeedStat> FQuickStatsRenderer::PublishedFeedStats;
+TArray<const IQuickStatsFeed*> FQuickStatsRenderer::PublishedFeeds;
+FQuickStatsSessionReport* FQuickStatsRenderer::SessionReport = nullptr;
+FQuickStatsCorrelation* FQuickStatsRenderer::Correlation = nullptr;
+FQuickStatsHeatmap* FQuickStatsRenderer::Heatmap = nullptr;
+uint64 FQuickStatsRenderer::HeatmapLocationFrameNumber = 0;
+TUniquePtr<FQuickStatsBaseline> FQuickStatsRenderer::Baseline;
+FQuickStatsRenderer::FBenchmarkState FQuickStatsRenderer::Benchmark;
+FQuickStatsSessionReport* FQuickStatsRenderer::BenchmarkReport = nullptr;
+bool FQuickStatsRenderer::bRegressionGateChecked = false;
+bool FQuickStatsRenderer::bIsHeadlessGate = false;
 
 const FName		FQuickStatsRenderer::QuickStatsPresetName = FName(TEXT("STAT_QuickStats"));
 const FName		FQuickStatsRenderer::QuickStatsPresetCategory = FName(TEXT("STATCAT_QuickStats"));
 const FText		FQuickStatsRenderer::QuickStatsPresetDescription = FText::FromString(FString(TEXT("Visualizer for quick stats.")));
 
+// padding and size are sort of magic numbers :^)
+static constexpr int32 StatsUniformPadding = 8;
+static constexpr int32 StatsPresetScopePadding = 8;
+
 FDelegateHandle FQuickStatsRenderer::ConsoleAutoCompleteHandle;
 FDelegateHandle FQuickStatsRenderer::OnObjectPropertyChangedHandle;
+FDelegateHandle FQuickStatsRenderer::OnEndFrameHandle;
+FDelegateHandle FQuickStatsRenderer::OnPreExitHandle;
+
+// rectangle as two triangles of a FCanvasTriangleItem
+static void AddQuad(TArray<FCanvasUVTri>& Triangles, const FVector2D& Min, const FVector2D& Max, const FLinearColor& Color)
+{
+	FCanvasUVTri& First = Triangles.AddDefaulted_GetRef();
+	First.V0_Pos = Min;
+	First.V1_Pos = FVector2D(Max.X, Min.Y);
+	First.V2_Pos = Max;
+	First.V0_UV = First.V1_UV = First.V2_UV = FVector2D::ZeroVector;
+	First.V0_Color = First.V1_Color = First.V2_Color = Color;
+
+	FCanvasUVTri& Second = Triangles.AddDefaulted_GetRef();
+	Second.V0_Pos = Min;
+	Second.V1_Pos = Max;
+	Second.V2_Pos = FVector2D(Min.X, Max.Y);
+	Second.V0_UV = Second.V1_UV = Second.V2_UV = FVector2D::ZeroVector;
+	Second.V0_Color = Second.V1_Color = Second.V2_Color = Color;
+}
 
 static TAutoConsoleVariable<FString> CVarEnabledPresets(
 	TEXT("qstats.Presets"),
@@ -33,9 +104,9 @@ static TAutoConsoleVariable<FString> CVarEnabledPresets(
 
 static FAutoConsoleCommand SetPresetCommand(
 	TEXT("qstats.SetPresets"),
-	TEXT("Set active stat presets.\n"),
-	FConsoleCommandWithArgsDelegate::CreateLambda(
-		[](const TArray<FString>& Args)
+	TEXT("Set active stat presets for this viewport.\n"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
 		{
 			TArray<FName> Presets;
 			for (const FString& PresetName : Args)
@@ -45,7 +116,7 @@ static FAutoConsoleCommand SetPresetCommand(
 
 			if (Presets.Num() > 0)
 			{
-				FQuickStatsRenderer::SetPresets_Command(Presets);
+				FQuickStatsRenderer::SetPresets_Command(World, Presets);
 			}
 		}
 	)
@@ -53,9 +124,9 @@ static FAutoConsoleCommand SetPresetCommand(
 
 static FAutoConsoleCommand EnablePresetCommand(
 	TEXT("qstats.EnablePresets"),
-	TEXT("Enable stat presets.\n"),
-	FConsoleCommandWithArgsDelegate::CreateLambda(
-		[](const TArray<FString>& Args)
+	TEXT("Enable stat presets for this viewport.\n"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
 		{
 			TArray<FName> Presets;
 			for (const FString& PresetName : Args)
@@ -65,7 +136,7 @@ static FAutoConsoleCommand EnablePresetCommand(
 
 			if (Presets.Num() > 0)
 			{
-				FQuickStatsRenderer::EnablePresets_Command(Presets);
+				FQuickStatsRenderer::EnablePresets_Command(World, Presets);
 			}
 		}
 	)
@@ -73,9 +144,9 @@ static FAutoConsoleCommand EnablePresetCommand(
 
 static FAutoConsoleCommand DisablePresetCommand(
 	TEXT("qstats.DisablePresets"),
-	TEXT("Disable stat presets.\n"),
-	FConsoleCommandWithArgsDelegate::CreateLambda(
-		[](const TArray<FString>& Args)
+	TEXT("Disable stat presets for this viewport.\n"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
 		{
 			TArray<FName> Presets;
 			for (const FString& PresetName : Args)
@@ -85,12 +156,98 @@ static FAutoConsoleCommand DisablePresetCommand(
 
 			if (Presets.Num() > 0)
 			{
-				FQuickStatsRenderer::DisablePresets_Command(Presets);
+				FQuickStatsRenderer::DisablePresets_Command(World, Presets);
+			}
+		}
+	)
+);
+
+static FAutoConsoleCommand NextPageCommand(
+	TEXT("qstats.NextPage"),
+	TEXT("Show next page of stats, used when stats don't fit the viewport.\n"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&FQuickStatsRenderer::NextPage_Command)
+);
+
+static FAutoConsoleCommand PreviousPageCommand(
+	TEXT("qstats.PreviousPage"),
+	TEXT("Show previous page of stats, used when stats don't fit the viewport.\n"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&FQuickStatsRenderer::PreviousPage_Command)
+);
+
+static FAutoConsoleCommand SetPageCommand(
+	TEXT("qstats.Page"),
+	TEXT("Show stats page, index starts from 1.\n"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args, UWorld* World)
+		{
+			if (Args.Num() > 0)
+			{
+				FQuickStatsRenderer::SetPage_Command(World, FCString::Atoi(*Args[0]) - 1);
+			}
+		}
+	)
+);
+
+static FAutoConsoleCommand ReportCommand(
+	TEXT("qstats.Report"),
+	TEXT("Write summary of the session (min/max/mean/percentiles/frames over budget) as JSON and CSV, optionally to the given path without extension.\n"),
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args)
+		{
+			FQuickStatsRenderer::WriteSessionReport_Command(Args.Num() > 0 ? Args[0] : FString());
+		}
+	)
+);
+
+static FAutoConsoleCommand ExportHeatmapCommand(
+	TEXT("qstats.ExportHeatmap"),
+	TEXT("Write the heatmap recorded so far to Saved/QuickStats/Heatmaps, recording continues.\n"),
+	FConsoleCommandDelegate::CreateStatic(&FQuickStatsRenderer::ExportHeatmap_Command)
+);
+
+static FAutoConsoleCommand CorrelateCommand(
+	TEXT("qstats.Correlate"),
+	TEXT("Log stats most correlated with the correlation target over the sliding window, optionally the number of stats to log.\n"),
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args)
+		{
+			FQuickStatsRenderer::Correlate_Command(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10);
+		}
+	)
+);
+
+static FAutoConsoleCommand CorrelationTargetCommand(
+	TEXT("qstats.CorrelationTarget"),
+	TEXT("Set the stat others are correlated with as Preset/StatDescription, FrameTime correlates with frame time.\n"),
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args)
+		{
+			// descriptions can have spaces
+			FQuickStatsRenderer::SetCorrelationTarget_Command(FString::Join(Args, TEXT(" ")));
+		}
+	)
+);
+
+static FAutoConsoleCommand BaselineCommand(
+	TEXT("qstats.Baseline"),
+	TEXT("Compare stats against a session report of an earlier run (JSON), None unloads the baseline.\n"),
+	FConsoleCommandWithArgsDelegate::CreateLambda(
+		[](const TArray<FString>& Args)
+		{
+			if (Args.Num() > 0)
+			{
+				FQuickStatsRenderer::LoadBaseline_Command(Args[0]);
 			}
 		}
 	)
 );
 
+static FAutoConsoleCommand CheckBaselineCommand(
+	TEXT("qstats.CheckBaseline"),
+	TEXT("Log stats of this session which regressed from the baseline.\n"),
+	FConsoleCommandDelegate::CreateStatic(&FQuickStatsRenderer::CheckBaseline_Command)
+);
+
 void FQuickStatsRenderer::RegisterStatPresets()
 {
 	checkf(GEngine, TEXT("GEngine is not valid, the stat visualizer won't be functional!"));
@@ -102,6 +259,8 @@ void FQuickStatsRenderer::RegisterStatPresets()
 	}
 
 	ConsoleAutoCompleteHandle = UConsole::RegisterConsoleAutoCompleteEntries.AddStatic(&FQuickStatsRenderer::PopulateAutoCompletePresetNames);
+	OnEndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FQuickStatsRenderer::OnEndFrame);
+	OnPreExitHandle = FCoreDelegates::OnPreExit.AddStatic(&FQuickStatsRenderer::OnPreExit);
 
 #if WITH_EDITOR
 	OnObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&FQuickStatsRenderer::OnObjectPropertyChanged);
@@ -110,6 +269,13 @@ void FQuickStatsRenderer::RegisterStatPresets()
 	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
 	check(Settings);
 
+	StatsCollector = MakeUnique<FQuickStatsCollector>();
+
+	// commandline baseline is used by automated runs
+	FString BaselineFilePath = Settings->BaselineFile.FilePath;
+	FParse::Value(FCommandLine::Get(), TEXT("-qstatsbaseline="), BaselineFilePath);
+	LoadBaseline(BaselineFilePath);
+
 	// check commandline for enabled presets
 	FString RequestedPresets = TEXT("");
 	if (!FParse::Value(FCommandLine::Get(), TEXT("-qstatpresets="), RequestedPresets, false))
@@ -118,25 +284,43 @@ void FQuickStatsRenderer::RegisterStatPresets()
 		RequestedPresets = CVarEnabledPresets.GetValueOnAnyThread();
 	}
 
-	if (!RequestedPresets.IsEmpty())
+	ParsePresetNames(Settings, RequestedPresets, EnabledPresets);
+
+	// headless benchmark, presets are evaluated without drawing and the app exits once frames are recorded
+	FString BenchmarkPresets;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-qstatsbench="), BenchmarkPresets, false))
 	{
-		UE::String::ParseTokens(RequestedPresets, TEXT(","),
-			[&](FStringView Token)
-			{
-				const FName PresetName(Token);
+		ParsePresetNames(Settings, BenchmarkPresets, Benchmark.Presets);
+		FParse::Value(FCommandLine::Get(), TEXT("-qstatsframes="), Benchmark.NumFrames);
+		FParse::Value(FCommandLine::Get(), TEXT("-qstatswarmup="), Benchmark.NumWarmupFrames);
+		FParse::Value(FCommandLine::Get(), TEXT("-qstatsout="), Benchmark.OutputPath);
 
-				if (Settings->StatPresets.Find(PresetName))
-				{
-					EnabledPresets.AddUnique(PresetName);
-				}
-				else if (PresetName != NAME_None) //None can be used to disable all preset.
-				{
-					UE_LOG(LogTemp, Warning, TEXT("Preset(%s) is not defined in QuickStatSettings!"), *PresetName.ToString());
-				}
-			}
-		);
+		if (Benchmark.Presets.Num() > 0 && Benchmark.NumFrames > 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("[QuickStat] Benchmarking %s for %d frames after %d warmup frames"), *BenchmarkPresets, Benchmark.NumFrames, Benchmark.NumWarmupFrames);
+			Benchmark.bIsRunning = true;
+			UpdateCollectedStats();
+			bStatStatesDirty = true;
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Benchmark needs at least one preset and -qstatsframes > 0"));
+		}
 	}
 
+	// headless runs with a baseline are a perf gate, nothing renders stats there so enabled presets are evaluated without a viewport.
+	// benchmark records its own report
+	if (Baseline && Settings->FailOnRegression && !Benchmark.bIsRunning && (FApp::IsUnattended() || GUsingNullRHI))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[QuickStat] Recording the session for the regression gate against baseline %s"), *Baseline->GetFilePath());
+		bIsHeadlessGate = true;
+		UpdateCollectedStats();
+		bStatStatesDirty = true;
+	}
+
+	// feeds are created last, the session report depends on the gate
+	UpdateFeeds(Settings);
+
 #if 0
 	// take the first preset if it's still empty
 	if (EnabledPresets.Num() == 0)
@@ -154,12 +338,30 @@ void FQuickStatsRenderer::RegisterStatPresets()
 
 void FQuickStatsRenderer::UnregisterStatPresets()
 {
+	for (auto& Itr : ViewStates)
+	{
+		RemoveOverlay(Itr.Value);
+	}
+	ViewStates.Reset();
+
+	Feeds.Reset();
+	PublishedFeeds.Reset();
+	PublishedFeedStats.Reset();
+	SessionReport = nullptr;
+	Correlation = nullptr;
+	Heatmap = nullptr;
+	BenchmarkReport = nullptr;
+	Baseline.Reset();
+	StatsCollector.Reset();
+
 	if (GEngine)
 	{
 		GEngine->RemoveEngineStat(QuickStatsPresetName);
 	}
 
 	UConsole::RegisterConsoleAutoCompleteEntries.Remove(ConsoleAutoCompleteHandle);
+	FCoreDelegates::OnEndFrame.Remove(OnEndFrameHandle);
+	FCoreDelegates::OnPreExit.Remove(OnPreExitHandle);
 
 #if WITH_EDITOR
 	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(OnObjectPropertyChangedHandle);
@@ -171,11 +373,146 @@ void FQuickStatsRenderer::OnObjectPropertyChanged(UObject* InObject, FPropertyCh
 {
 	if (InObject->IsA(UQuickStatPreset::StaticClass()))
 	{
-		SetEnabledPresets(EnabledPresets);
+		UpdateCollectedStats();
+		bStatStatesDirty = true;
+	}
+	else if (InObject->IsA(UQuickStatSettings::StaticClass()))
+	{
+		// feeds are configured when created
+		const FString PropertyCategory = InChangeEvent.Property ? InChangeEvent.Property->GetMetaData(TEXT("Category")) : FString();
+		if (PropertyCategory.StartsWith(TEXT("Feeds")))
+		{
+			UpdateFeeds(CastChecked<UQuickStatSettings>(InObject));
+		}
+		else if (PropertyCategory == TEXT("Baseline"))
+		{
+			LoadBaseline(CastChecked<UQuickStatSettings>(InObject)->BaselineFile.FilePath);
+		}
+
+		// presets or row layout might have changed
+		bStatStatesDirty = true;
+	}
+}
+#endif
+
+void FQuickStatsRenderer::OnEndFrame()
+{
+	RemoveClosedViews();
+
+	if (StatsCollector)
+	{
+		StatsCollector->RecordEngineSnapshot();
+	}
+
+	// viewports evaluate stats when rendering, this only catches frames which weren't rendered
+	if (StatsCollector && (!StatsCollector->IsCollectingStats() || StatsCollector->GetNumQueuedFrames() > 0))
+	{
+		if (Heatmap && HeatmapLocationFrameNumber != GFrameCounter)
+		{
+			UpdateHeatmapLocation();
+		}
+		EvaluateStats(GetDefault<UQuickStatSettings>());
+	}
+
+	if (Benchmark.bIsRunning)
+	{
+		UpdateBenchmark();
+	}
+
+	// headless runs act as a perf gate, exit requested this frame (quit command, automation) gets the exit code of the gate
+	if (!bRegressionGateChecked && IsEngineExitRequested() && (FApp::IsUnattended() || GUsingNullRHI))
+	{
+		const uint8 ExitCode = RunRegressionGate(GetDefault<UQuickStatSettings>(), SessionReport);
+		if (ExitCode != 0)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+		}
 	}
 }
+
+void FQuickStatsRenderer::RemoveClosedViews()
+{
+	bool bViewsChanged = false;
+	for (auto Itr = ViewStates.CreateIterator(); Itr; ++Itr)
+	{
+		FViewState& View = Itr.Value();
+
+		bool bIsClosed = View.GameViewportClient.IsStale();
+#if WITH_EDITOR
+		// editor viewport clients unregister themselves when destroyed
+		if (View.bIsEditorViewport && GEditor)
+		{
+			const FViewportClient* ViewportClient = Itr.Key();
+			bIsClosed |= !GEditor->GetAllViewportClients().ContainsByPredicate([ViewportClient](const FEditorViewportClient* EditorViewportClient) { return EditorViewportClient == ViewportClient; });
+		}
 #endif
 
+		if (bIsClosed)
+		{
+			RemoveOverlay(View);
+			bViewsChanged |= View.bIsRenderingStats;
+			Itr.RemoveCurrent();
+		}
+	}
+
+	if (bViewsChanged)
+	{
+		UpdateCollectedStats();
+		bStatStatesDirty = true;
+	}
+}
+
+void FQuickStatsRenderer::OnPreExit()
+{
+	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
+
+	if (SessionReport && (Settings->WriteSessionReportOnExit || FParse::Param(FCommandLine::Get(), TEXT("qstatsreport"))))
+	{
+		SessionReport->WriteReport(FQuickStatsSessionReport::GetDefaultReportPath());
+	}
+
+	// exit was requested after the last end of frame, the main loop is over and the exit code can't be set reliably anymore
+	if (!bRegressionGateChecked && (FApp::IsUnattended() || GUsingNullRHI))
+	{
+		if (RunRegressionGate(Settings, SessionReport) != 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Exit was requested outside of a frame, exit code may not report the regressions."));
+			FPlatformMisc::RequestExitWithStatus(false, 1);
+		}
+	}
+}
+
+uint8 FQuickStatsRenderer::RunRegressionGate(const UQuickStatSettings* Settings, const FQuickStatsSessionReport* Report)
+{
+	bRegressionGateChecked = true;
+	if (!Baseline || !Settings->FailOnRegression)
+	{
+		return 0;
+	}
+
+	// a gate that didn't compare anything didn't pass
+	if (!Report)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[QuickStat] Session wasn't recorded, can't compare with baseline %s, exit code 1"), *Baseline->GetFilePath());
+		return 1;
+	}
+
+	const FBaselineCheck Check = CheckBaseline(Settings, *Report);
+	if (Check.NumComparedStats == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[QuickStat] No stat of baseline %s was evaluated (-qstatpresets or -qstatsbench), exit code 1"), *Baseline->GetFilePath());
+		return 1;
+	}
+	if (Check.NumRegressedStats > 0 || Check.NumMissingStats > 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[QuickStat] %d stats regressed from baseline %s and %d weren't evaluated, exit code 1"), Check.NumRegressedStats, *Baseline->GetFilePath(), Check.NumMissingStats);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("[QuickStat] No stat regressed from baseline %s, exit code 0"), *Baseline->GetFilePath());
+	return 0;
+}
+
 void FQuickStatsRenderer::PopulateAutoCompletePresetNames(TArray<FAutoCompleteCommand>& AutoCompleteList)
 {
 	const UConsoleSettings* ConsoleSettings = GetDefault<UConsoleSettings>();
@@ -230,13 +567,22 @@ void FQuickStatsRenderer::PopulateAutoCompletePresetNames(TArray<FAutoCompleteCo
 
 int32 FQuickStatsRenderer::OnRenderStats(UWorld* World, FViewport* Viewport, FCanvas* Canvas, int32 X, int32 Y, const FVector* ViewLocation, const FRotator* ViewRotation)
 {
-	if (GAreScreenMessagesEnabled && bIsRenderingStats)
+	FViewState& View = FindOrAddView(Viewport->GetClient(), World);
+
+	if (GAreScreenMessagesEnabled)
 	{
+		// engine only renders the stat for viewports which enabled it, the toggle might not have gone through us (restored editor viewports)
+		if (!View.bIsRenderingStats)
+		{
+			View.bIsRenderingStats = true;
+			UpdateCollectedStats();
+			bStatStatesDirty = true;
+		}
+
 		const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
 		const float ViewportOffsetX = Settings->ViewportOffsetX;
 		const float ViewportOffsetY = Settings->ViewportOffsetY;
 		const int32 ColumnSpacing = Settings->ColumnSpacing;
-		const int32 StatDescriptionMaxLength = Settings->StatDescriptionMaxLength;
 		const FLinearColor& BackgroundColor = Settings->BackgroundColor;
 		const bool bShowPresetNames = Settings->ShowPresetNames;
 
@@ -246,251 +592,1292 @@ int32 FQuickStatsRenderer::OnRenderStats(UWorld* World, FViewport* Viewport, FCa
 		X += ViewportOffsetX;
 		Y += ViewportOffsetY;
 
-		auto ShortenName = [&](const FString& LongName)
+		const int32 UniformPadding = StatsUniformPadding;
+		const int32 PresetScopePadding = bShowPresetNames ? StatsPresetScopePadding : 0;
+
+		if (Heatmap && ViewLocation)
 		{
-			if (LongName.Len() > StatDescriptionMaxLength)
-			{
-				return FString(TEXT("...")) + LongName.Right(StatDescriptionMaxLength);
-			}
-			return LongName;
-		};
+			Heatmap->SetViewLocation(*ViewLocation);
+			HeatmapLocationFrameNumber = GFrameCounter;
+		}
+
+		EvaluateStats(Settings);
+
+		const bool bHasStatsToRender = UpdateViewRows(Settings, View);
+		const TArray<FQuickStatsRow>& StatRows = View.StatRows;
+
+		TSharedPtr<SQuickStatsOverlay> Overlay;
+		if (Settings->UseSlateOverlay)
+		{
+			Overlay = FindOrCreateOverlay(View, World, Viewport);
+		}
+		else if (View.Overlay.IsValid())
+		{
+			RemoveOverlay(View);
+		}
 
-		auto CalculateStatColor = [](double StatValue, double StatBudget)
+		if (Overlay.IsValid())
 		{
-			FColor Color = FColor::Green;
-			
-			if (StatBudget > 0.)
+			TArray<FQuickStatsRow> OverlayRows;
+			// cell of every row in the grid of the overlay, X is the column of the page and Y the row in that column
+			TArray<FIntPoint> OverlayCells;
+			int32 OverlayHeight = RowHeight;
+
+			if (!bHasStatsToRender)
+			{
+				FQuickStatsRow& MessageRow = OverlayRows.AddDefaulted_GetRef();
+				MessageRow.Text = TEXT("No preset selected!");
+				MessageRow.Color = FColor::Red;
+				MessageRow.bIsPresetName = true;
+				OverlayCells.Add(FIntPoint(INDEX_NONE, INDEX_NONE));
+			}
+			else
 			{
-				if (StatValue > StatBudget)
+				// rows are split into columns and pages like on canvas, the grid of the overlay only aligns them
+				UpdateStatsLayout(Settings, View, Font, Viewport->GetSizeXY(), FIntPoint(X, Y));
+
+				const FStatsLayout& Layout = View.Layout;
+				const int32 NumPages = Layout.Pages.Num();
+				const int32 PageIndex = FMath::Clamp(View.CurrentPageIndex, 0, NumPages - 1);
+				const FPageLayout& Page = Layout.Pages[PageIndex];
+
+				OverlayRows.Reserve(Page.NumRows + 1);
+				OverlayCells.Reserve(Page.NumRows + 1);
+				const int32 FirstColumnIndex = Layout.Rows[Page.FirstRow].ColumnIndex;
+				for (int32 RowIndex = Page.FirstRow; RowIndex < Page.FirstRow + Page.NumRows; ++RowIndex)
 				{
-					Color = FColor::Red;
+					const FRowLayout& RowLayout = Layout.Rows[RowIndex];
+					OverlayRows.Add(StatRows[RowIndex]);
+					OverlayCells.Add(FIntPoint(RowLayout.ColumnIndex - FirstColumnIndex, RowIndex - Layout.Columns[RowLayout.ColumnIndex].FirstRow));
 				}
-				else if (StatValue > StatBudget * 0.75)
+
+				// footer spans all the columns below them
+				if (NumPages > 1)
 				{
-					Color = FColor::Yellow;
+					OverlayRows.Add(GetPageFooter(View, PageIndex));
+					OverlayCells.Add(FIntPoint(INDEX_NONE, INDEX_NONE));
 				}
+
+				OverlayHeight = Page.Size.Y - 2 * UniformPadding;
 			}
 
-			return Color;
-		};
+			Overlay->SetRows(OverlayRows, OverlayCells);
 
-		int32 NumStatsToRender = 0;
-		for (FName PresetName : EnabledPresets)
-		{
-			if (const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName))
-			{
-				NumStatsToRender += StatPreset->StatsToDisplay.Num();
-			}
-		}
+			// slate units are scaled by DPI, unlike canvas
+			const float DPIScale = GetDefault<UUserInterfaceSettings>()->GetDPIScaleBasedOnSize(Viewport->GetSizeXY());
+			const FVector2D OverlayPosition = FVector2D(X - UniformPadding, Y - UniformPadding) / FMath::Max(DPIScale, KINDA_SMALL_NUMBER);
+			Overlay->SetLayout(OverlayPosition, ColumnSpacing, PresetScopePadding, BackgroundColor);
 
-		if (NumStatsToRender > 0)
+			Y += OverlayHeight;
+		}
+		else
 		{
-			if (FGameThreadStatsData* StatsData = FLatestGameThreadStatsData::Get().Latest)
+			if (bHasStatsToRender)
 			{
-				const int32 NumRowsToDraw = NumStatsToRender + (bShowPresetNames ? EnabledPresets.Num() : 0);
+				if (StatRows.Num() > 0)
+				{
+					UpdateStatsLayout(Settings, View, Font, Viewport->GetSizeXY(), FIntPoint(X, Y));
 
-				// padding and size are sort of magic numbers :^)
-				const int32 UniformPadding = 8;
-				const int32 PresetScopePadding = bShowPresetNames ? 8 : 0;
-				const int32 StatValueTextWidth = 64;
-				const int32 Width = ColumnSpacing + StatValueTextWidth + UniformPadding + PresetScopePadding;
-				const int32 Height = RowHeight * NumRowsToDraw + 2 * UniformPadding;
-				Canvas->DrawTile(X - UniformPadding, Y - UniformPadding, Width, Height, 0.f, 0.f, 1.f, 1.f, BackgroundColor);
+					const FStatsLayout& Layout = View.Layout;
+					const int32 NumPages = Layout.Pages.Num();
+					const int32 PageIndex = FMath::Clamp(View.CurrentPageIndex, 0, NumPages - 1);
+					const FPageLayout& Page = Layout.Pages[PageIndex];
 
-				// lookup for counter stats
-				TMap<FName, const FComplexStatMessage*> StatNameToCounterStats;
-				for (const auto& Group : StatsData->ActiveStatGroups)
-				{
-					for (const FComplexStatMessage& CounterStatMessage : Group.CountersAggregate)
+					Canvas->DrawTile(X - UniformPadding, Y - UniformPadding, Page.Size.X, Page.Size.Y, 0.f, 0.f, 1.f, 1.f, BackgroundColor);
+
+					TArray<FCanvasUVTri> BarTriangles;
+					for (int32 RowIndex = Page.FirstRow; RowIndex < Page.FirstRow + Page.NumRows; ++RowIndex)
 					{
-						const FName StatName = CounterStatMessage.GetShortName();
-						StatNameToCounterStats.Add(StatName, &CounterStatMessage);
-					}
-				}
+						const FQuickStatsRow& Row = StatRows[RowIndex];
+						const FRowLayout& RowLayout = Layout.Rows[RowIndex];
 
-				const FQuickStatEvaluationContext EvaluationContext{ StatsData->NameToStatMap, StatNameToCounterStats };
+						if (Row.bIsBar)
+						{
+							// bar spans the name column
+							const float BarWidth = RowLayout.ValuePosition.X - RowLayout.TextPosition.X - UniformPadding;
+							AddStackedBar(BarTriangles, Row, FVector2D(X + RowLayout.TextPosition.X, Y + RowLayout.TextPosition.Y), BarWidth, RowHeight);
+						}
+						else if (Row.SegmentColor.A > 0)
+						{
+							const float SwatchSize = RowHeight * 0.6f;
+							const FVector2D SwatchMin(X + RowLayout.TextPosition.X - RowHeight, Y + RowLayout.TextPosition.Y + (RowHeight - SwatchSize) * 0.5f);
+							AddQuad(BarTriangles, SwatchMin, SwatchMin + FVector2D(SwatchSize, SwatchSize), Row.SegmentColor);
+						}
 
-				for (FName PresetName : EnabledPresets)
-				{
-					if (bShowPresetNames)
-					{
-						Canvas->DrawShadowedString(X, Y, *PresetName.ToString(), Font, FColor::Green);
-						Y += RowHeight;
+						Canvas->DrawShadowedString(X + RowLayout.TextPosition.X, Y + RowLayout.TextPosition.Y, *Row.Text, Font, Row.Color);
+						if (!Row.bIsPresetName)
+						{
+							Canvas->DrawShadowedString(X + RowLayout.ValuePosition.X, Y + RowLayout.ValuePosition.Y, *Row.ValueText, Font, Row.Color);
+						}
 					}
 
-					if (const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName))
+					// all the bars and swatches of the page in one draw
+					if (BarTriangles.Num() > 0)
 					{
-						const TArray<FQuickStat>& StatsToDisplay = StatPreset->StatsToDisplay;
-						for (const FQuickStat& Stat : StatsToDisplay)
-						{
-							// default values for invalid stat
-							const FString StatDescStr = ShortenName(Stat.StatDescription);
-							FString StatValueStr = TEXT("N/A");
-							FColor StatColor = FColor::Magenta;
-
-							double StatValue;
-							if (Stat.StatExpression && Stat.StatExpression->Evaluate(EvaluationContext, StatValue))
-							{
-								StatValueStr = FString::Printf(TEXT("%0.2f"), StatValue);
-								StatColor = CalculateStatColor(StatValue, Stat.Budget);
-							}
-
-							Canvas->DrawShadowedString(X + PresetScopePadding, Y, *StatDescStr, Font, StatColor);
-							Canvas->DrawShadowedString(X + PresetScopePadding + ColumnSpacing, Y, *StatValueStr, Font, StatColor);
-							Y += RowHeight;
-						}
+						FCanvasTriangleItem BarItem(BarTriangles, GWhiteTexture);
+						BarItem.BlendMode = SE_BLEND_Translucent;
+						Canvas->DrawItem(BarItem);
+					}
 
+					if (NumPages > 1)
+					{
+						const FQuickStatsRow PageFooter = GetPageFooter(View, PageIndex);
+						const int32 FooterY = Y + Page.Size.Y - 2 * UniformPadding - RowHeight;
+						Canvas->DrawShadowedString(X, FooterY, *PageFooter.Text, Font, PageFooter.Color);
 					}
+
+					Y += Page.Size.Y - 2 * UniformPadding;
 				}
 			}
-		}
-		else
-		{
-			Canvas->DrawShadowedString(X, Y, TEXT("No preset selected!"), Font, FColor::Red);
+			else
+			{
+				Canvas->DrawShadowedString(X, Y, TEXT("No preset selected!"), Font, FColor::Red);
+			}
 		}
 	}
+	else if (View.Overlay.IsValid())
+	{
+		RemoveOverlay(View);
+	}
 
 	return Y;
 }
 
-bool FQuickStatsRenderer::OnToggleStats(UWorld* World, FCommonViewportClient* ViewportClient, const TCHAR* Stream)
+FQuickStatsRenderer::FViewState* FQuickStatsRenderer::FindViewForWorld(UWorld* World)
 {
-	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
-
-	bIsRenderingStats = !bIsRenderingStats;
-	
-	TSet<FName> StatGroupsToToggle;
-	for (FName PresetName : EnabledPresets)
+	const FViewportClient* GameViewportClient = World ? World->GetGameViewport() : nullptr;
+	if (GameViewportClient)
 	{
-		if (const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName))
-		{
-			for (const FQuickStat& Stat : StatPreset->StatsToDisplay)
-			{
-				if (Stat.StatExpression)
-				{
-					StatGroupsToToggle.Append(Stat.StatExpression->GetRequiredStatGroupNames());
-				}
-			}
-		}
+		return &FindOrAddView(GameViewportClient, World);
 	}
+	return nullptr;
+}
 
-	if (bIsRenderingStats)
+FQuickStatsRenderer::FViewState& FQuickStatsRenderer::FindOrAddView(const FViewportClient* ViewportClient, UWorld* World)
+{
+	FViewState* View = ViewStates.Find(ViewportClient);
+	if (!View)
 	{
-		for (FName StatGroup : StatGroupsToToggle)
+		View = &ViewStates.Add(ViewportClient);
+
+		// remember what kind of client this is, so the view can be removed with it
+		UGameViewportClient* GameViewportClient = World ? World->GetGameViewport() : nullptr;
+		if (GameViewportClient && GameViewportClient == ViewportClient)
 		{
-			EnableStatGroup(StatGroup);
+			View->GameViewportClient = GameViewportClient;
 		}
-
-		EnabledStatGroups = StatGroupsToToggle;
-	}
-	else
-	{
-		for (FName StatGroup : StatGroupsToToggle)
+#if WITH_EDITOR
+		else if (GEditor)
 		{
-			DisableStatGroup(StatGroup);
+			View->bIsEditorViewport = GEditor->GetAllViewportClients().ContainsByPredicate([ViewportClient](const FEditorViewportClient* EditorViewportClient) { return EditorViewportClient == ViewportClient; });
 		}
-
-		EnabledStatGroups.Reset();
+#endif
 	}
+	return *View;
+}
 
-	return false;
+const TArray<FName>& FQuickStatsRenderer::GetViewPresets(const FViewState& View)
+{
+	return View.bUseDefaultPresets ? EnabledPresets : View.EnabledPresets;
 }
 
-void FQuickStatsRenderer::EnableStatGroup(FName StatGroupName)
+void FQuickStatsRenderer::RebuildStatStates(const UQuickStatSettings* Settings)
 {
-	if (GEngine)
-	{
-		if (FGameThreadStatsData* StatsData = FLatestGameThreadStatsData::Get().Latest)
-		{
-			if (StatsData->GroupNames.Contains(StatGroupName))
-			{
-				// stat group is already active!
-				return;
-			}
-		}
+	PresetStates.Reset();
+	StatStates.Reset();
+	EveryFrameStatIndices.Reset();
+	SampleSchedule.Reset();
 
-		FString GroupName = StatGroupName.ToString();
-		if (GroupName.RemoveFromStart(TEXT("STATGROUP_")))
-		{
-			const FString StatCommand = FString::Printf(TEXT("stat %s -nodisplay"), *GroupName);
-			GEngine->Exec(nullptr, *StatCommand);
-		}
+	for (auto& Itr : ViewStates)
+	{
+		Itr.Value.bStatRowsDirty = true;
 	}
-}
 
-void FQuickStatsRenderer::DisableStatGroup(FName StatGroupName)
-{
-	if (GEngine)
+	// presets shown by multiple viewports are only evaluated once
+	TArray<FName> PresetNames;
+	GetEvaluatedPresets(PresetNames);
+
+	for (FName PresetName : PresetNames)
 	{
-		if (FGameThreadStatsData* StatsData = FLatestGameThreadStatsData::Get().Latest)
+		const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName);
+
+		const int32 PresetIndex = PresetStates.AddDefaulted();
+		FPresetState& PresetState = PresetStates[PresetIndex];
+		PresetState.PresetName = PresetName;
+		PresetState.FirstStatIndex = StatStates.Num();
+
+		const float RefreshRate = (StatPreset && StatPreset->RefreshRate > 0.f) ? StatPreset->RefreshRate : Settings->RefreshRate;
+		PresetState.RefreshInterval = (RefreshRate > 0.f) ? 1. / RefreshRate : 0.;
+
+		if (StatPreset && StatPreset->DisplayMode == EQuickStatPresetDisplayMode::StackedBar)
 		{
-			if (!StatsData->GroupNames.Contains(StatGroupName))
+			PresetState.bIsStackedBar = true;
+			PresetState.BarBudget = StatPreset->BarBudget;
+			if (PresetState.BarBudget <= 0.)
 			{
-				// stat group is not active!
-				return;
+				for (const FQuickStat& Stat : StatPreset->StatsToDisplay)
+				{
+					PresetState.BarBudget += FMath::Max(Stat.Budget, 0.);
+				}
 			}
+		}
 
-			FString GroupName = StatGroupName.ToString();
-			if (GroupName.RemoveFromStart(TEXT("STATGROUP_")))
-			{
-				const FString StatCommand = FString::Printf(TEXT("stat %s -nodisplay"), *GroupName);
-				GEngine->Exec(nullptr, *StatCommand);
+		if (StatPreset)
+		{
+			for (const FQuickStat& Stat : StatPreset->StatsToDisplay)
+			{
+				FStatState& StatState = StatStates.AddDefaulted_GetRef();
+				StatState.Stat = &Stat;
+				StatState.PresetIndex = PresetIndex;
+
+				StatState.BaselineValue = std::numeric_limits<double>::quiet_NaN();
+				if (Baseline)
+				{
+					Baseline->FindValue(PresetName, Stat.StatDescription, Settings->BaselineMetric, StatState.BaselineValue);
+				}
+				StatState.RegressionTolerance = GetRegressionTolerance(Settings, Stat);
+				StatState.AbsoluteRegressionTolerance = GetAbsoluteRegressionTolerance(Settings, Stat);
+
+				if (Stat.DetectAnomalies)
+				{
+					StatState.AnomalyDetector.Emplace(Settings->AnomalyWindow, Settings->AnomalyZScore, Settings->ChangePointThreshold);
+				}
+
+				// sampled stats are due right away, so they have a value on the first frame
+				const int32 StatIndex = StatStates.Num() - 1;
+				StatState.SamplingPeriod = FMath::Max(Stat.SamplingPeriod, 0.f);
+				if (StatState.SamplingPeriod > 0.)
+				{
+					StatState.FrameValue = std::numeric_limits<double>::quiet_NaN();
+					SampleSchedule.HeapPush(FScheduledSample{ 0., StatIndex });
+				}
+				else
+				{
+					EveryFrameStatIndices.Add(StatIndex);
+				}
+			}
+		}
+		PresetState.NumStats = StatStates.Num() - PresetState.FirstStatIndex;
+	}
+
+	PublishFeedSchema(Settings);
+
+	LastEvaluatedFrameNumber = 0;
+	bStatStatesDirty = false;
+}
+
+void FQuickStatsRenderer::EvaluateStats(const UQuickStatSettings* Settings)
+{
+	if (bStatStatesDirty)
+	{
+		RebuildStatStates(Settings);
+	}
+
+	// stats are rendered for every viewport, but should only be evaluated once per frame
+	if (StatStates.Num() == 0 || LastEvaluatedFrameNumber == GFrameCounter)
+	{
+		return;
+	}
+	LastEvaluatedFrameNumber = GFrameCounter;
+
+	ActiveFeeds.Reset();
+	for (const TUniquePtr<IQuickStatsFeed>& Feed : Feeds)
+	{
+		if (Feed->IsActive())
+		{
+			ActiveFeeds.Add(Feed.Get());
+		}
+	}
+	const bool bPublishValues = (ActiveFeeds.Num() > 0);
+
+	// feeds need values every frame regardless of pages and refresh rate
+	for (int32 StatIndex = 0; StatIndex < StatStates.Num(); ++StatIndex)
+	{
+		StatStates[StatIndex].bIsRequiredByFeeds = ActiveFeeds.ContainsByPredicate([StatIndex](const IQuickStatsFeed* Feed) { return Feed->IsStatRequired(StatIndex); });
+	}
+
+	// stats on other pages are skipped, unless they can go over budget or have anomaly detection
+	bool bAllStatsVisible = false;
+	for (const auto& Itr : ViewStates)
+	{
+		bAllStatsVisible |= (Itr.Value.bIsRenderingStats && Itr.Value.bStatRowsDirty);
+	}
+	for (FStatState& StatState : StatStates)
+	{
+		StatState.bIsVisible = bAllStatsVisible || (StatState.Stat->Budget > 0.) || StatState.AnomalyDetector.IsSet();
+	}
+	if (!bAllStatsVisible)
+	{
+		for (const auto& Itr : ViewStates)
+		{
+			const FViewState& View = Itr.Value;
+			if (View.bIsRenderingStats)
+			{
+				for (int32 RowIndex = 0; RowIndex < View.RowBindings.Num(); ++RowIndex)
+				{
+					const FRowBinding& RowBinding = View.RowBindings[RowIndex];
+					if (RowBinding.StatIndex != INDEX_NONE && IsStatRowVisible(View, RowIndex))
+					{
+						StatStates[RowBinding.StatIndex].bIsVisible = true;
+					}
+					else if (RowBinding.BarPresetIndex != INDEX_NONE && IsStatRowVisible(View, RowIndex))
+					{
+						// the bar needs all the stats of its preset
+						const FPresetState& PresetState = PresetStates[RowBinding.BarPresetIndex];
+						for (int32 StatIndex = PresetState.FirstStatIndex; StatIndex < PresetState.FirstStatIndex + PresetState.NumStats; ++StatIndex)
+						{
+							StatStates[StatIndex].bIsVisible = true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	auto CalculateStatColor = [](double StatValue, double StatBudget)
+	{
+		FColor Color = FColor::Green;
+		
+		if (StatBudget > 0.)
+		{
+			if (StatValue > StatBudget)
+			{
+				Color = FColor::Red;
+			}
+			else if (StatValue > StatBudget * 0.75)
+			{
+				Color = FColor::Yellow;
 			}
 		}
+
+		return Color;
+	};
+
+	// with a baseline, stats are colored by their change (as a fraction of the allowed change) instead of the budget
+	auto CalculateDeltaColor = [](double ToleranceRatio)
+	{
+		if (ToleranceRatio > 1.)
+		{
+			return FColor::Red;
+		}
+		else if (ToleranceRatio > 0.5)
+		{
+			return FColor::Yellow;
+		}
+		else if (ToleranceRatio < -1.)
+		{
+			return FColor::Cyan;
+		}
+		return FColor::Green;
+	};
+
+	const EQuickStatRefreshAggregation Aggregation = Settings->RefreshAggregation;
+
+	// every frame delivered by the stats thread since last evaluation is evaluated in order,
+	// values are refreshed once stats thread catches up
+	if (!StatsCollector->IsCollectingStats())
+	{
+		// nothing to wait for from the stats thread
+		StatsCollector->QueueFrame(GFrameCounter, FApp::GetDeltaTime() * 1000.);
+	}
+
+	const int32 NumFrames = StatsCollector->GetNumQueuedFrames();
+	if (NumFrames == 0)
+	{
+		return;
+	}
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	for (FPresetState& PresetState : PresetStates)
+	{
+		PresetState.bRefreshThisFrame = (CurrentTime >= PresetState.NextRefreshTime);
+		if (PresetState.bRefreshThisFrame)
+		{
+			PresetState.NextRefreshTime = CurrentTime + PresetState.RefreshInterval;
+		}
+	}
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames && StatsCollector->PopFrame(); ++FrameIndex)
+	{
+		const bool bIsLastFrame = (FrameIndex == NumFrames - 1);
+		const FQuickStatEvaluationContext EvaluationContext{ StatsCollector->GetStats(), StatsCollector->GetCounterStats(), &StatsCollector->GetEngineSnapshot() };
+		const double FrameTime = StatsCollector->GetFrameTime();
+
+		// slowly changing stats are only evaluated when due, their last sample is reused in between
+		while (SampleSchedule.Num() > 0 && SampleSchedule.HeapTop().NextSampleTime <= FrameTime)
+		{
+			FScheduledSample Sample;
+			SampleSchedule.HeapPop(Sample, false);
+
+			FStatState& StatState = StatStates[Sample.StatIndex];
+			double StatValue;
+			StatState.FrameValue = (StatState.Stat->StatExpression && StatState.Stat->StatExpression->Evaluate(EvaluationContext, StatValue)) ? StatValue : std::numeric_limits<double>::quiet_NaN();
+			DetectAnomaly(Settings, StatState, StatsCollector->GetFrameNumber(), FrameTime);
+
+			// missed samples are skipped instead of sampling every frame to catch up
+			Sample.NextSampleTime += StatState.SamplingPeriod;
+			if (Sample.NextSampleTime <= FrameTime)
+			{
+				Sample.NextSampleTime = FrameTime + StatState.SamplingPeriod;
+			}
+			SampleSchedule.HeapPush(Sample);
+		}
+
+		for (int32 StatIndex : EveryFrameStatIndices)
+		{
+			FStatState& StatState = StatStates[StatIndex];
+			StatState.FrameValue = std::numeric_limits<double>::quiet_NaN();
+
+			if (!StatState.bIsVisible && !StatState.bIsRequiredByFeeds)
+			{
+				continue;
+			}
+
+			// between refreshes values are only evaluated if they need to be aggregated
+			const bool bRefreshStat = bIsLastFrame && PresetStates[StatState.PresetIndex].bRefreshThisFrame;
+
+			double StatValue;
+			if ((bRefreshStat || StatState.bIsRequiredByFeeds || StatState.AnomalyDetector.IsSet() || Aggregation != EQuickStatRefreshAggregation::Latest)
+				&& StatState.Stat->StatExpression && StatState.Stat->StatExpression->Evaluate(EvaluationContext, StatValue))
+			{
+				StatState.FrameValue = StatValue;
+				DetectAnomaly(Settings, StatState, StatsCollector->GetFrameNumber(), FrameTime);
+
+				if (Aggregation == EQuickStatRefreshAggregation::Max)
+				{
+					StatState.AccumulatedValue = (StatState.NumAccumulatedValues > 0) ? FMath::Max(StatState.AccumulatedValue, StatValue) : StatValue;
+				}
+				else if (Aggregation == EQuickStatRefreshAggregation::Mean)
+				{
+					StatState.AccumulatedValue += StatValue;
+				}
+				else
+				{
+					StatState.AccumulatedValue = StatValue;
+				}
+				StatState.NumAccumulatedValues++;
+			}
+		}
+
+		if (bPublishValues)
+		{
+			FeedValues.Reset(StatStates.Num());
+			for (const FStatState& StatState : StatStates)
+			{
+				FeedValues.Add(StatState.FrameValue);
+			}
+
+			for (IQuickStatsFeed* Feed : ActiveFeeds)
+			{
+				Feed->OnRawStatsAvailable(EvaluationContext);
+				Feed->OnStatsEvaluated(StatsCollector->GetFrameNumber(), StatsCollector->GetFrameTime(), StatsCollector->GetFrameDuration(), FeedValues);
+			}
+		}
+	}
+
+	// units of code stats are resolved from the last evaluated frame
+	const FQuickStatEvaluationContext LastFrameContext{ StatsCollector->GetStats(), StatsCollector->GetCounterStats(), &StatsCollector->GetEngineSnapshot() };
+
+	for (FStatState& StatState : StatStates)
+	{
+		if (PresetStates[StatState.PresetIndex].bRefreshThisFrame)
+		{
+			// sampled stats display their last sample, it isn't aggregated
+			const bool bIsSampled = (StatState.SamplingPeriod > 0.);
+			if (bIsSampled ? !FMath::IsNaN(StatState.FrameValue) : StatState.NumAccumulatedValues > 0)
+			{
+				const double DisplayValue = bIsSampled ? StatState.FrameValue
+					: (Aggregation == EQuickStatRefreshAggregation::Mean) ? StatState.AccumulatedValue / StatState.NumAccumulatedValues : StatState.AccumulatedValue;
+				const EQuickStatUnit Unit = (StatState.Stat->Unit == EQuickStatUnit::Auto && StatState.Stat->StatExpression) ? StatState.Stat->StatExpression->GetUnit(LastFrameContext) : StatState.Stat->Unit;
+				StatState.ValueText = FQuickStatUnits::FormatValue(DisplayValue, Unit);
+				StatState.DisplayValue = DisplayValue;
+				StatState.DisplayUnit = Unit;
+
+				if (!FMath::IsNaN(StatState.BaselineValue))
+				{
+					// change from a zero baseline isn't relative, it's shown in the unit of the stat
+					if (FMath::Abs(StatState.BaselineValue) > SMALL_NUMBER)
+					{
+						StatState.ValueText += FString::Printf(TEXT(" (%+.1f%%)"), FQuickStatsBaseline::GetRelativeDelta(DisplayValue, StatState.BaselineValue) * 100.);
+					}
+					else
+					{
+						const double Delta = DisplayValue - StatState.BaselineValue;
+						StatState.ValueText += FString::Printf(TEXT(" (%s%s)"), Delta < 0. ? TEXT("-") : TEXT("+"), *FQuickStatUnits::FormatValue(FMath::Abs(Delta), Unit));
+					}
+					StatState.Color = CalculateDeltaColor(FQuickStatsBaseline::GetToleranceRatio(DisplayValue, StatState.BaselineValue, StatState.RegressionTolerance, StatState.AbsoluteRegressionTolerance));
+				}
+				else
+				{
+					StatState.Color = CalculateStatColor(DisplayValue, StatState.Stat->Budget);
+				}
+			}
+			else
+			{
+				StatState.ValueText = TEXT("N/A");
+				StatState.Color = FColor::Magenta;
+				StatState.DisplayValue = std::numeric_limits<double>::quiet_NaN();
+			}
+			StatState.RefreshCount++;
+
+			StatState.AccumulatedValue = 0.;
+			StatState.NumAccumulatedValues = 0;
+		}
+	}
+
+	// stacked bars show the total against the preset budget, and every stat its share of the total
+	for (FPresetState& PresetState : PresetStates)
+	{
+		if (!PresetState.bIsStackedBar || !PresetState.bRefreshThisFrame)
+		{
+			continue;
+		}
+
+		double Total = 0.;
+		EQuickStatUnit Unit = EQuickStatUnit::Count;
+		bool bHasValues = false;
+		for (int32 StatIndex = PresetState.FirstStatIndex; StatIndex < PresetState.FirstStatIndex + PresetState.NumStats; ++StatIndex)
+		{
+			const FStatState& StatState = StatStates[StatIndex];
+			if (!FMath::IsNaN(StatState.DisplayValue))
+			{
+				Total += FMath::Max(StatState.DisplayValue, 0.);
+				Unit = bHasValues ? Unit : StatState.DisplayUnit;
+				bHasValues = true;
+			}
+		}
+
+		if (bHasValues)
+		{
+			PresetState.BarValueText = FQuickStatUnits::FormatValue(Total, Unit);
+			if (PresetState.BarBudget > 0.)
+			{
+				PresetState.BarValueText += TEXT(" / ") + FQuickStatUnits::FormatValue(PresetState.BarBudget, Unit);
+			}
+			PresetState.BarColor = CalculateStatColor(Total, PresetState.BarBudget);
+
+			// bar is scaled to the budget, or to the total once it's over budget
+			const double Scale = FMath::Max(Total, PresetState.BarBudget);
+			PresetState.BarSegments.Reset();
+			PresetState.BarBudgetFraction = (PresetState.BarBudget > 0. && Scale > 0.) ? static_cast<float>(PresetState.BarBudget / Scale) : -1.f;
+
+			for (int32 StatIndex = PresetState.FirstStatIndex; StatIndex < PresetState.FirstStatIndex + PresetState.NumStats; ++StatIndex)
+			{
+				FStatState& StatState = StatStates[StatIndex];
+				if (!FMath::IsNaN(StatState.DisplayValue) && Total > 0.)
+				{
+					StatState.ValueText += FString::Printf(TEXT(" %.0f%%"), FMath::Max(StatState.DisplayValue, 0.) / Total * 100.);
+				}
+
+				if (!FMath::IsNaN(StatState.DisplayValue) && StatState.DisplayValue > 0. && Scale > 0.)
+				{
+					FQuickStatsBarSegment& Segment = PresetState.BarSegments.AddDefaulted_GetRef();
+					Segment.Fraction = static_cast<float>(StatState.DisplayValue / Scale);
+					Segment.Color = GetSegmentColor(StatIndex - PresetState.FirstStatIndex);
+					Segment.bIsOverBudget = (StatState.Stat->Budget > 0. && StatState.DisplayValue > StatState.Stat->Budget);
+				}
+			}
+		}
+		else
+		{
+			PresetState.BarValueText = TEXT("N/A");
+			PresetState.BarColor = FColor::Magenta;
+			PresetState.BarSegments.Reset();
+			PresetState.BarBudgetFraction = -1.f;
+		}
+		PresetState.RefreshCount++;
+	}
+
+	// recent anomalies override the budget color
+	for (FStatState& StatState : StatStates)
+	{
+		if (PresetStates[StatState.PresetIndex].bRefreshThisFrame && CurrentTime - StatState.LastAnomalyTime < Settings->AnomalyHighlightDuration)
+		{
+			StatState.ValueText += TEXT(" !");
+			StatState.Color = FColor::Orange;
+		}
+	}
+}
+
+bool FQuickStatsRenderer::UpdateViewRows(const UQuickStatSettings* Settings, FViewState& View)
+{
+	if (View.bStatRowsDirty)
+	{
+		View.StatRows.Reset();
+		View.RowBindings.Reset();
+		View.NumStatRows = 0;
+
+		const int32 StatDescriptionMaxLength = Settings->StatDescriptionMaxLength;
+		const bool bShowPresetNames = Settings->ShowPresetNames;
+
+		auto ShortenName = [&](const FString& LongName)
+		{
+			if (LongName.Len() > StatDescriptionMaxLength)
+			{
+				return FString(TEXT("...")) + LongName.Right(StatDescriptionMaxLength);
+			}
+			return LongName;
+		};
+
+		for (FName PresetName : GetViewPresets(View))
+		{
+			if (bShowPresetNames)
+			{
+				FQuickStatsRow& PresetRow = View.StatRows.AddDefaulted_GetRef();
+				PresetRow.Text = PresetName.ToString();
+				PresetRow.Color = FColor::Green;
+				PresetRow.bIsPresetName = true;
+
+				View.RowBindings.AddDefaulted();
+			}
+
+			const int32 PresetIndex = PresetStates.IndexOfByPredicate([PresetName](const FPresetState& State) { return State.PresetName == PresetName; });
+			const FPresetState* PresetState = (PresetIndex != INDEX_NONE) ? &PresetStates[PresetIndex] : nullptr;
+			if (PresetState)
+			{
+				// bar is drawn in place of the name of an empty row, its value is the total
+				if (PresetState->bIsStackedBar && PresetState->NumStats > 0)
+				{
+					FQuickStatsRow& BarRow = View.StatRows.AddDefaulted_GetRef();
+					BarRow.ValueText = PresetState->BarValueText;
+					BarRow.Color = PresetState->BarColor;
+					BarRow.bIsBar = true;
+					BarRow.BarSegments = PresetState->BarSegments;
+					BarRow.BarBudgetFraction = PresetState->BarBudgetFraction;
+
+					FRowBinding& RowBinding = View.RowBindings.AddDefaulted_GetRef();
+					RowBinding.BarPresetIndex = PresetIndex;
+					RowBinding.RefreshCount = PresetState->RefreshCount;
+				}
+
+				for (int32 StatIndex = PresetState->FirstStatIndex; StatIndex < PresetState->FirstStatIndex + PresetState->NumStats; ++StatIndex)
+				{
+					const FStatState& StatState = StatStates[StatIndex];
+
+					FQuickStatsRow& StatRow = View.StatRows.AddDefaulted_GetRef();
+					StatRow.Text = ShortenName(StatState.Stat->StatDescription);
+					StatRow.ValueText = StatState.ValueText;
+					StatRow.Color = StatState.Color;
+					if (PresetState->bIsStackedBar)
+					{
+						StatRow.SegmentColor = GetSegmentColor(StatIndex - PresetState->FirstStatIndex);
+					}
+
+					FRowBinding& RowBinding = View.RowBindings.AddDefaulted_GetRef();
+					RowBinding.StatIndex = StatIndex;
+					RowBinding.RefreshCount = StatState.RefreshCount;
+
+					View.NumStatRows++;
+				}
+			}
+		}
+
+		View.Layout.bDirty = true;
+		View.bStatRowsDirty = false;
+	}
+	else
+	{
+		// only copy values refreshed since last frame
+		for (int32 RowIndex = 0; RowIndex < View.RowBindings.Num(); ++RowIndex)
+		{
+			FRowBinding& RowBinding = View.RowBindings[RowIndex];
+			if (RowBinding.StatIndex != INDEX_NONE && RowBinding.RefreshCount != StatStates[RowBinding.StatIndex].RefreshCount)
+			{
+				const FStatState& StatState = StatStates[RowBinding.StatIndex];
+				View.StatRows[RowIndex].ValueText = StatState.ValueText;
+				View.StatRows[RowIndex].Color = StatState.Color;
+				RowBinding.RefreshCount = StatState.RefreshCount;
+			}
+			else if (RowBinding.BarPresetIndex != INDEX_NONE && RowBinding.RefreshCount != PresetStates[RowBinding.BarPresetIndex].RefreshCount)
+			{
+				const FPresetState& PresetState = PresetStates[RowBinding.BarPresetIndex];
+				View.StatRows[RowIndex].ValueText = PresetState.BarValueText;
+				View.StatRows[RowIndex].Color = PresetState.BarColor;
+				View.StatRows[RowIndex].BarSegments = PresetState.BarSegments;
+				View.StatRows[RowIndex].BarBudgetFraction = PresetState.BarBudgetFraction;
+				RowBinding.RefreshCount = PresetState.RefreshCount;
+			}
+		}
+	}
+
+	return View.NumStatRows > 0;
+}
+
+void FQuickStatsRenderer::UpdateStatsLayout(const UQuickStatSettings* Settings, FViewState& View, const UFont* Font, FIntPoint ViewportSize, FIntPoint Origin)
+{
+	const TArray<FQuickStatsRow>& StatRows = View.StatRows;
+	FStatsLayout& Layout = View.Layout;
+
+	if (!Layout.bDirty && Layout.Font.Get() == Font && Layout.ViewportSize == ViewportSize && Layout.Origin == Origin && Layout.Rows.Num() == StatRows.Num())
+	{
+		// only values change between layout passes, re-measure the ones with different text length and grow the value column if needed
+		for (int32 RowIndex = 0; RowIndex < StatRows.Num(); ++RowIndex)
+		{
+			const FQuickStatsRow& Row = StatRows[RowIndex];
+			FRowLayout& RowLayout = Layout.Rows[RowIndex];
+			if (!Row.bIsPresetName && Row.ValueText.Len() != RowLayout.MeasuredValueLength)
+			{
+				RowLayout.MeasuredValueLength = Row.ValueText.Len();
+				if (Font->GetStringSize(*Row.ValueText) > Layout.Columns[RowLayout.ColumnIndex].ValueColumnWidth)
+				{
+					Layout.bDirty = true;
+				}
+			}
+		}
+
+		if (!Layout.bDirty)
+		{
+			return;
+		}
+	}
+
+	const int32 NumRows = StatRows.Num();
+	const int32 RowHeight = FMath::TruncToInt(Font->GetMaxCharHeight() * 1.1f);
+	const int32 PresetScopePadding = Settings->ShowPresetNames ? StatsPresetScopePadding : 0;
+	// stats of stacked bars are prefixed with the color of their segment
+	const int32 SwatchWidth = RowHeight;
+
+	// one row is reserved for page footer
+	const int32 AvailableHeight = ViewportSize.Y - Origin.Y - 2 * StatsUniformPadding - RowHeight;
+	const int32 AvailableWidth = ViewportSize.X - Origin.X;
+	const int32 RowsPerColumn = FMath::Max(1, AvailableHeight / FMath::Max(RowHeight, 1));
+
+	Layout.Rows.SetNum(NumRows);
+	Layout.Columns.Reset();
+	Layout.Pages.Reset();
+
+	// pack rows into columns, preset names are not left alone at the bottom of a column
+	for (int32 RowIndex = 0; RowIndex < NumRows;)
+	{
+		FColumnLayout& Column = Layout.Columns.AddDefaulted_GetRef();
+		Column.FirstRow = RowIndex;
+		while (RowIndex < NumRows && Column.NumRows < RowsPerColumn)
+		{
+			const bool bOrphanPresetName = StatRows[RowIndex].bIsPresetName && Column.NumRows > 0 && (Column.NumRows + 1) == RowsPerColumn;
+			if (bOrphanPresetName)
+			{
+				break;
+			}
+			Column.NumRows++;
+			RowIndex++;
+		}
+	}
+
+	// measure columns and pack them into pages fitting the viewport width
+	int32 PageOffsetX = 0;
+	for (int32 ColumnIndex = 0; ColumnIndex < Layout.Columns.Num(); ++ColumnIndex)
+	{
+		FColumnLayout& Column = Layout.Columns[ColumnIndex];
+
+		int32 PresetNameColumnWidth = 0;
+		int32 StatNameColumnWidth = 0;
+		int32 ValueColumnWidth = 0;
+		for (int32 RowIndex = Column.FirstRow; RowIndex < Column.FirstRow + Column.NumRows; ++RowIndex)
+		{
+			const FQuickStatsRow& Row = StatRows[RowIndex];
+			if (Row.bIsPresetName)
+			{
+				PresetNameColumnWidth = FMath::Max(PresetNameColumnWidth, Font->GetStringSize(*Row.Text));
+			}
+			else
+			{
+				StatNameColumnWidth = FMath::Max(StatNameColumnWidth, Font->GetStringSize(*Row.Text) + (Row.SegmentColor.A > 0 ? SwatchWidth : 0));
+				ValueColumnWidth = FMath::Max(ValueColumnWidth, Font->GetStringSize(*Row.ValueText));
+				Layout.Rows[RowIndex].MeasuredValueLength = Row.ValueText.Len();
+			}
+		}
+
+		// ColumnSpacing is the minimum offset of values from stat names
+		const int32 ValueColumnOffset = PresetScopePadding + FMath::Max(Settings->ColumnSpacing, StatNameColumnWidth + StatsUniformPadding);
+		const int32 ColumnWidth = FMath::Max(PresetNameColumnWidth, ValueColumnOffset + ValueColumnWidth);
+		Column.ValueColumnWidth = ValueColumnWidth;
+
+		if (Layout.Pages.Num() == 0 || (PageOffsetX > 0 && PageOffsetX + ColumnWidth > AvailableWidth))
+		{
+			FPageLayout& NewPage = Layout.Pages.AddDefaulted_GetRef();
+			NewPage.FirstRow = Column.FirstRow;
+			PageOffsetX = 0;
+		}
+
+		const int32 PageIndex = Layout.Pages.Num() - 1;
+		FPageLayout& Page = Layout.Pages[PageIndex];
+
+		for (int32 RowIndex = Column.FirstRow; RowIndex < Column.FirstRow + Column.NumRows; ++RowIndex)
+		{
+			FRowLayout& RowLayout = Layout.Rows[RowIndex];
+			const int32 RowY = (RowIndex - Column.FirstRow) * RowHeight;
+			const FQuickStatsRow& Row = StatRows[RowIndex];
+			RowLayout.TextPosition = FIntPoint(PageOffsetX + (Row.bIsPresetName ? 0 : PresetScopePadding) + (Row.SegmentColor.A > 0 ? SwatchWidth : 0), RowY);
+			RowLayout.ValuePosition = FIntPoint(PageOffsetX + ValueColumnOffset, RowY);
+			RowLayout.ColumnIndex = ColumnIndex;
+			RowLayout.PageIndex = PageIndex;
+		}
+
+		Page.NumRows += Column.NumRows;
+		Page.Size.X = PageOffsetX + ColumnWidth;
+		Page.Size.Y = FMath::Max(Page.Size.Y, Column.NumRows * RowHeight);
+
+		PageOffsetX += ColumnWidth + 2 * StatsUniformPadding;
+	}
+
+	for (FPageLayout& Page : Layout.Pages)
+	{
+		Page.Size += FIntPoint(2 * StatsUniformPadding, 2 * StatsUniformPadding);
+		if (Layout.Pages.Num() > 1)
+		{
+			Page.Size.Y += RowHeight;
+		}
+	}
+
+	Layout.Font = Font;
+	Layout.ViewportSize = ViewportSize;
+	Layout.Origin = Origin;
+	Layout.bDirty = false;
+}
+
+bool FQuickStatsRenderer::IsStatRowVisible(const FViewState& View, int32 RowIndex)
+{
+	const FStatsLayout& Layout = View.Layout;
+	if (Layout.bDirty || Layout.Pages.Num() <= 1 || !Layout.Rows.IsValidIndex(RowIndex))
+	{
+		return true;
+	}
+	return Layout.Rows[RowIndex].PageIndex == FMath::Clamp(View.CurrentPageIndex, 0, Layout.Pages.Num() - 1);
+}
+
+FColor FQuickStatsRenderer::GetSegmentColor(int32 SegmentIndex)
+{
+	// distinct from the red used for over budget segments
+	static const FColor Palette[] =
+	{
+		FColor(66, 133, 244),
+		FColor(255, 167, 38),
+		FColor(171, 71, 188),
+		FColor(0, 172, 193),
+		FColor(124, 179, 66),
+		FColor(236, 64, 122),
+		FColor(92, 107, 192),
+		FColor(141, 110, 99),
+	};
+	return Palette[SegmentIndex % UE_ARRAY_COUNT(Palette)];
+}
+
+void FQuickStatsRenderer::AddStackedBar(TArray<FCanvasUVTri>& Triangles, const FQuickStatsRow& BarRow, FVector2D Position, float Width, float Height)
+{
+	const float BarHeight = Height * 0.7f;
+	const FVector2D BarMin(Position.X, Position.Y + (Height - BarHeight) * 0.5f);
+	AddQuad(Triangles, BarMin, BarMin + FVector2D(Width, BarHeight), FLinearColor(0.1f, 0.1f, 0.1f, 0.8f));
+
+	if (Width <= 0.f)
+	{
+		return;
+	}
+
+	float SegmentX = BarMin.X;
+	for (const FQuickStatsBarSegment& Segment : BarRow.BarSegments)
+	{
+		const float SegmentWidth = Segment.Fraction * Width;
+		const FVector2D SegmentMin(SegmentX, BarMin.Y);
+		const FVector2D SegmentMax(SegmentX + SegmentWidth, BarMin.Y + BarHeight);
+		AddQuad(Triangles, SegmentMin, SegmentMax, Segment.Color);
+
+		// stats over their own budget are outlined
+		if (Segment.bIsOverBudget)
+		{
+			const float Border = FMath::Min(2.f, SegmentWidth * 0.5f);
+			AddQuad(Triangles, SegmentMin, FVector2D(SegmentMax.X, SegmentMin.Y + 2.f), FColor::Red);
+			AddQuad(Triangles, FVector2D(SegmentMin.X, SegmentMax.Y - 2.f), SegmentMax, FColor::Red);
+			AddQuad(Triangles, SegmentMin, FVector2D(SegmentMin.X + Border, SegmentMax.Y), FColor::Red);
+			AddQuad(Triangles, FVector2D(SegmentMax.X - Border, SegmentMin.Y), SegmentMax, FColor::Red);
+		}
+		SegmentX += SegmentWidth;
+	}
+
+	// budget marker
+	if (BarRow.BarBudgetFraction >= 0.f)
+	{
+		const float MarkerX = BarMin.X + BarRow.BarBudgetFraction * Width;
+		AddQuad(Triangles, FVector2D(MarkerX - 1.f, Position.Y), FVector2D(MarkerX + 1.f, Position.Y + Height), FColor::White);
+	}
+}
+
+FQuickStatsRow FQuickStatsRenderer::GetPageFooter(const FViewState& View, int32 PageIndex)
+{
+	const FStatsLayout& Layout = View.Layout;
+
+	// stats with budget are evaluated on every page, so over budget stats can be reported
+	int32 NumOverBudgetRowsOnOtherPages = 0;
+	for (int32 RowIndex = 0; RowIndex < View.StatRows.Num() && RowIndex < Layout.Rows.Num(); ++RowIndex)
+	{
+		if (Layout.Rows[RowIndex].PageIndex != PageIndex && View.StatRows[RowIndex].Color == FColor::Red)
+		{
+			NumOverBudgetRowsOnOtherPages++;
+		}
+	}
+
+	FQuickStatsRow Footer;
+	Footer.Text = FString::Printf(TEXT("Page %d/%d (qstats.NextPage)"), PageIndex + 1, Layout.Pages.Num());
+	if (NumOverBudgetRowsOnOtherPages > 0)
+	{
+		Footer.Text += FString::Printf(TEXT(" - %d over budget"), NumOverBudgetRowsOnOtherPages);
+	}
+	Footer.Color = (NumOverBudgetRowsOnOtherPages > 0) ? FColor::Red : FColor::White;
+	Footer.bIsPresetName = true;
+	return Footer;
+}
+
+TSharedPtr<SQuickStatsOverlay> FQuickStatsRenderer::FindOrCreateOverlay(FViewState& View, UWorld* World, FViewport* Viewport)
+{
+	// overlay can only be added to game viewports, editor viewports keep using canvas
+	UGameViewportClient* GameViewportClient = World ? World->GetGameViewport() : nullptr;
+	if (!GameViewportClient || GameViewportClient->Viewport != Viewport)
+	{
+		return nullptr;
+	}
+
+	if (!View.Overlay.IsValid())
+	{
+		View.Overlay = SNew(SQuickStatsOverlay);
+		View.OverlayViewportClient = GameViewportClient;
+		GameViewportClient->AddViewportWidgetContent(View.Overlay.ToSharedRef(), INT32_MAX);
+	}
+	return View.Overlay;
+}
+
+void FQuickStatsRenderer::RemoveOverlay(FViewState& View)
+{
+	if (View.Overlay.IsValid())
+	{
+		if (UGameViewportClient* GameViewportClient = View.OverlayViewportClient.Get())
+		{
+			GameViewportClient->RemoveViewportWidgetContent(View.Overlay.ToSharedRef());
+		}
+	}
+	View.Overlay.Reset();
+	View.OverlayViewportClient.Reset();
+}
+
+bool FQuickStatsRenderer::OnToggleStats(UWorld* World, FCommonViewportClient* ViewportClient, const TCHAR* Stream)
+{
+	if (ViewportClient)
+	{
+		FViewState& View = FindOrAddView(ViewportClient, World);
+		View.bIsRenderingStats = !View.bIsRenderingStats;
+	}
+	else
+	{
+		// toggled without a viewport (commandline, cheat manager), affects all the viewports
+		bool bIsAnyViewRenderingStats = false;
+		for (const auto& Itr : ViewStates)
+		{
+			bIsAnyViewRenderingStats |= Itr.Value.bIsRenderingStats;
+		}
+		for (auto& Itr : ViewStates)
+		{
+			Itr.Value.bIsRenderingStats = !bIsAnyViewRenderingStats;
+		}
+	}
+
+	for (auto& Itr : ViewStates)
+	{
+		if (!Itr.Value.bIsRenderingStats)
+		{
+			RemoveOverlay(Itr.Value);
+		}
 	}
+
+	UpdateCollectedStats();
+	bStatStatesDirty = true;
+
+	return false;
 }
 
-void FQuickStatsRenderer::SetEnabledPresets(TArray<FName> NewPresets)
+void FQuickStatsRenderer::UpdateCollectedStats()
 {
+	if (!StatsCollector)
+	{
+		return;
+	}
+
 	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
 
-	// if rendering we need to enable/disable stat-groups accordingly
-	if (bIsRenderingStats)
-	{
-		TSet<FName> StatGroupsToDisable = EnabledStatGroups;
+	// stats are collected once for presets of all the viewports rendering stats
+	TArray<FName> PresetNames;
+	const bool bCollectFrames = GetEvaluatedPresets(PresetNames);
 
-		TSet<FName> StatGroupsToEnable;
-		for (FName PresetName : NewPresets)
+	TSet<FName> StatNames;
+	TSet<FName> StatGroupNames;
+	for (FName PresetName : PresetNames)
+	{
+		if (const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName))
 		{
-			if (const UQuickStatPreset* StatPreset = Settings->GetPresetByName(PresetName))
+			for (const FQuickStat& Stat : StatPreset->StatsToDisplay)
 			{
-				for (const FQuickStat& Stat : StatPreset->StatsToDisplay)
+				if (Stat.StatExpression)
 				{
-					if (Stat.StatExpression)
-					{
-						const TArray<FName> RequiredGroupNames = Stat.StatExpression->GetRequiredStatGroupNames().Array();
-						for (FName GroupName : RequiredGroupNames)
-						{
-							StatGroupsToEnable.Add(GroupName);
-							StatGroupsToDisable.Remove(GroupName);
-						}
-					}
+					StatNames.Append(Stat.StatExpression->GetRequiredStatNames());
+					StatGroupNames.Append(Stat.StatExpression->GetRequiredStatGroupNames());
 				}
 			}
 		}
+	}
+	StatNames.Remove(NAME_None);
+
+	StatsCollector->SetRequiredStats(bCollectFrames, StatNames, StatGroupNames);
+}
+
+bool FQuickStatsRenderer::GetEvaluatedPresets(TArray<FName>& OutPresetNames)
+{
+	bool bIsEvaluatingStats = false;
+	for (const auto& Itr : ViewStates)
+	{
+		if (Itr.Value.bIsRenderingStats)
+		{
+			bIsEvaluatingStats = true;
+			for (FName PresetName : GetViewPresets(Itr.Value))
+			{
+				OutPresetNames.AddUnique(PresetName);
+			}
+		}
+	}
+
+	// regression gate evaluates the enabled presets without a viewport
+	if (bIsHeadlessGate)
+	{
+		bIsEvaluatingStats = true;
+		for (FName PresetName : EnabledPresets)
+		{
+			OutPresetNames.AddUnique(PresetName);
+		}
+	}
+
+	// benchmark presets are evaluated without a viewport
+	if (Benchmark.bIsRunning)
+	{
+		bIsEvaluatingStats = true;
+		for (FName PresetName : Benchmark.Presets)
+		{
+			OutPresetNames.AddUnique(PresetName);
+		}
+	}
+
+	return bIsEvaluatingStats;
+}
+
+void FQuickStatsRenderer::ParsePresetNames(const UQuickStatSettings* Settings, const FString& PresetList, TArray<FName>& OutPresetNames)
+{
+	UE::String::ParseTokens(PresetList, TEXT(","),
+		[&](FStringView Token)
+		{
+			const FName PresetName(Token);
+
+			if (Settings->StatPresets.Find(PresetName))
+			{
+				OutPresetNames.AddUnique(PresetName);
+			}
+			else if (PresetName != NAME_None) //None can be used to disable all preset.
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Preset(%s) is not defined in QuickStatSettings!"), *PresetName.ToString());
+			}
+		}
+	);
+}
+
+void FQuickStatsRenderer::UpdateBenchmark()
+{
+	// report is created after warmup, so frames spent loading aren't recorded
+	if (!BenchmarkReport)
+	{
+		if (Benchmark.NumWarmupFrames > 0)
+		{
+			Benchmark.NumWarmupFrames--;
+			return;
+		}
+
+		TUniquePtr<FQuickStatsSessionReport> Report = MakeUnique<FQuickStatsSessionReport>();
+		BenchmarkReport = Report.Get();
+		Feeds.Add(MoveTemp(Report));
+
+		// new feed needs the schema
+		bStatStatesDirty = true;
+		return;
+	}
+
+	if (BenchmarkReport->GetNumFrames() >= Benchmark.NumFrames)
+	{
+		Benchmark.bIsRunning = false;
+
+		BenchmarkReport->WriteReport(Benchmark.OutputPath.IsEmpty() ? FQuickStatsSessionReport::GetDefaultReportPath() : Benchmark.OutputPath);
+
+		// gated before exit is requested, so the exit code is set while the main loop still runs
+		const uint8 ExitCode = RunRegressionGate(GetDefault<UQuickStatSettings>(), BenchmarkReport);
+		UE_LOG(LogTemp, Display, TEXT("[QuickStat] Benchmark finished, exiting with code %d"), ExitCode);
+		FPlatformMisc::RequestExitWithStatus(false, ExitCode);
+	}
+}
+
+void FQuickStatsRenderer::UpdateFeeds(const UQuickStatSettings* Settings)
+{
+	// session and benchmark reports cover the whole session, they survive changes to other feeds
+	TUniquePtr<IQuickStatsFeed> SessionReportFeed;
+	TUniquePtr<IQuickStatsFeed> BenchmarkReportFeed;
+	for (TUniquePtr<IQuickStatsFeed>& Feed : Feeds)
+	{
+		if (Feed.Get() == SessionReport)
+		{
+			SessionReportFeed = MoveTemp(Feed);
+		}
+		else if (Feed.Get() == BenchmarkReport)
+		{
+			BenchmarkReportFeed = MoveTemp(Feed);
+		}
+	}
+	SessionReport = nullptr;
+	Correlation = nullptr;
+	Heatmap = nullptr;
+
+	Feeds.Reset();
+	PublishedFeeds.Reset();
+
+	// report needs every stat every frame, so it's opt-in unless the regression gate needs it
+	if (Settings->RecordSessionReport || bIsHeadlessGate || FParse::Param(FCommandLine::Get(), TEXT("qstatsreport")))
+	{
+		if (!SessionReportFeed)
+		{
+			SessionReportFeed = MakeUnique<FQuickStatsSessionReport>();
+		}
+		SessionReport = static_cast<FQuickStatsSessionReport*>(SessionReportFeed.Get());
+		Feeds.Add(MoveTemp(SessionReportFeed));
+	}
+
+	if (BenchmarkReportFeed)
+	{
+		Feeds.Add(MoveTemp(BenchmarkReportFeed));
+	}
+
+	if (Settings->PublishSharedMemoryFeed)
+	{
+		TUniquePtr<FQuickStatsSharedMemoryFeed> SharedMemoryFeed = MakeUnique<FQuickStatsSharedMemoryFeed>();
+		if (SharedMemoryFeed->IsValid())
+		{
+			Feeds.Add(MoveTemp(SharedMemoryFeed));
+		}
+	}
+
+	if (Settings->StreamStats)
+	{
+		TUniquePtr<FQuickStatsStreamingFeed> StreamingFeed = MakeUnique<FQuickStatsStreamingFeed>(Settings->StreamingPort, Settings->StreamingListenOnAllInterfaces, Settings->StreamingFramesPerPacket);
+		if (StreamingFeed->IsValid())
+		{
+			Feeds.Add(MoveTemp(StreamingFeed));
+		}
+	}
+
+	if (Settings->CaptureHitches)
+	{
+		Feeds.Add(MakeUnique<FQuickStatsHitchCapture>(*Settings));
+	}
+
+	if (Settings->RecordHeatmap || FParse::Param(FCommandLine::Get(), TEXT("qstatsheatmap")))
+	{
+		TUniquePtr<FQuickStatsHeatmap> HeatmapFeed = MakeUnique<FQuickStatsHeatmap>(Settings->HeatmapCellSize, Settings->HeatmapIncludeHeight);
+		Heatmap = HeatmapFeed.Get();
+		Feeds.Add(MoveTemp(HeatmapFeed));
+	}
+
+	if (Settings->AnalyzeCorrelation)
+	{
+		TUniquePtr<FQuickStatsCorrelation> CorrelationFeed = MakeUnique<FQuickStatsCorrelation>(Settings->CorrelationWindow, Settings->CorrelationTarget);
+		Correlation = CorrelationFeed.Get();
+		Feeds.Add(MoveTemp(CorrelationFeed));
+	}
+
+	if (Settings->RecordCapture || FParse::Param(FCommandLine::Get(), TEXT("qstatscapture")))
+	{
+		Feeds.Add(MakeUnique<FQuickStatsCaptureFeed>(Settings->CaptureSegmentFrames, static_cast<int64>(Settings->CaptureSegmentSize) * 1024 * 1024));
+	}
+
+#if QUICKSTATS_TRACE_ENABLED
+	// always available, only active while QuickStats trace channel is enabled
+	Feeds.Add(MakeUnique<FQuickStatsTraceFeed>());
+#endif
+
+#if QUICKSTATS_CSV_ENABLED
+	// only active while a CSV capture is running
+	Feeds.Add(MakeUnique<FQuickStatsCsvFeed>());
+#endif
+
+	// new feeds need the schema
+	bStatStatesDirty = true;
+}
+
+void FQuickStatsRenderer::PublishFeedSchema(const UQuickStatSettings* Settings)
+{
+	if (Feeds.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FQuickStatsFeedStat> FeedStats;
+	FeedStats.Reserve(StatStates.Num());
+	for (const FStatState& StatState : StatStates)
+	{
+		FQuickStatsFeedStat& FeedStat = FeedStats.AddDefaulted_GetRef();
+		FeedStat.PresetName = PresetStates[StatState.PresetIndex].PresetName;
+		FeedStat.StatDescription = StatState.Stat->StatDescription;
+		FeedStat.Budget = StatState.Stat->Budget;
+
+		const UQuickStatPreset* StatPreset = Settings->GetPresetByName(FeedStat.PresetName);
+		FeedStat.bRecordToCsv = StatPreset && StatPreset->RecordToCsv;
 
-		for (FName StatGroup : StatGroupsToDisable)
+		if (StatState.Stat->StatExpression)
 		{
-			DisableStatGroup(StatGroup);
+			FeedStat.RequiredStatNames = StatState.Stat->StatExpression->GetRequiredStatNames().Array();
 		}
-		for (FName StatGroup : StatGroupsToEnable)
+	}
+
+	// stat states are rebuilt for changes that don't affect the schema (toggles, pages, baseline),
+	// feeds restart their recording on schema change so they only get it when it's different or when they are new
+	if (FeedStats != PublishedFeedStats)
+	{
+		PublishedFeedStats = MoveTemp(FeedStats);
+		PublishedFeeds.Reset();
+	}
+
+	for (const TUniquePtr<IQuickStatsFeed>& Feed : Feeds)
+	{
+		if (!PublishedFeeds.Contains(Feed.Get()))
 		{
-			EnableStatGroup(StatGroup);
+			Feed->OnSchemaChanged(PublishedFeedStats);
+			PublishedFeeds.Add(Feed.Get());
 		}
+	}
+}
 
-		EnabledStatGroups = StatGroupsToEnable;
+void FQuickStatsRenderer::SetEnabledPresets(UWorld* World, TArray<FName> NewPresets)
+{
+	if (FViewState* View = FindViewForWorld(World))
+	{
+		View->EnabledPresets = MoveTemp(NewPresets);
+		View->bUseDefaultPresets = false;
+	}
+	else
+	{
+		EnabledPresets = MoveTemp(NewPresets);
 	}
 
-	EnabledPresets = NewPresets;
+	// if rendering we need to enable/disable stat-groups accordingly
+	UpdateCollectedStats();
+	bStatStatesDirty = true;
 }
 
-void FQuickStatsRenderer::SetPresets_Command(const TArray<FName>& PresetNames)
+void FQuickStatsRenderer::SetPresets_Command(UWorld* World, const TArray<FName>& PresetNames)
 {
 	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
 
 	if (PresetNames.Contains(NAME_None))
 	{
-		SetEnabledPresets(TArray<FName>());
+		SetEnabledPresets(World, TArray<FName>());
 	}
 	else
 	{
@@ -507,16 +1894,19 @@ void FQuickStatsRenderer::SetPresets_Command(const TArray<FName>& PresetNames)
 
 		if (NewPresets.Num() > 0)
 		{
-			SetEnabledPresets(NewPresets);
+			SetEnabledPresets(World, NewPresets);
 		}
 	}
 }
 
-void FQuickStatsRenderer::EnablePresets_Command(const TArray<FName>& PresetNames)
+void FQuickStatsRenderer::EnablePresets_Command(UWorld* World, const TArray<FName>& PresetNames)
 {
 	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
-	
-	TArray<FName> NewPresets = EnabledPresets;
+
+	const FViewState* View = FindViewForWorld(World);
+	const TArray<FName>& CurrentPresets = View ? GetViewPresets(*View) : EnabledPresets;
+
+	TArray<FName> NewPresets = CurrentPresets;
 	
 	for (FName PresetName : PresetNames)
 	{
@@ -527,23 +1917,26 @@ void FQuickStatsRenderer::EnablePresets_Command(const TArray<FName>& PresetNames
 	}
 	
 	// did we add any new preset?
-	if (NewPresets.Num() > EnabledPresets.Num())
+	if (NewPresets.Num() > CurrentPresets.Num())
 	{
-		SetEnabledPresets(NewPresets);
+		SetEnabledPresets(World, NewPresets);
 	}
 }
 
-void FQuickStatsRenderer::DisablePresets_Command(const TArray<FName>& PresetNames)
+void FQuickStatsRenderer::DisablePresets_Command(UWorld* World, const TArray<FName>& PresetNames)
 {
 	const UQuickStatSettings* Settings = GetDefault<UQuickStatSettings>();
 
 	if (PresetNames.Contains(FName(TEXT("All"))))
 	{
-		SetEnabledPresets(TArray<FName>());
+		SetEnabledPresets(World, TArray<FName>());
 	}
 	else
 	{
-		TArray<FName> NewPresets = EnabledPresets;
+		const FViewState* View = FindViewForWorld(World);
+		const TArray<FName>& CurrentPresets = View ? GetViewPresets(*View) : EnabledPresets;
+
+		TArray<FName> NewPresets = CurrentPresets;
 
 		for (FName PresetName : PresetNames)
 		{
@@ -554,11 +1947,222 @@ void FQuickStatsRenderer::DisablePresets_Command(const TArray<FName>& PresetName
 		}
 
 		// did we disable any preset?
-		if (NewPresets.Num() < EnabledPresets.Num())
+		if (NewPresets.Num() < CurrentPresets.Num())
+		{
+			SetEnabledPresets(World, NewPresets);
+		}
+	}
+}
+
+void FQuickStatsRenderer::ChangePage(UWorld* World, TFunctionRef<int32(int32 CurrentPageIndex)> GetNewPageIndex)
+{
+	auto ChangeViewPage = [&](FViewState& View)
+	{
+		const int32 NumPages = FMath::Max(View.Layout.Pages.Num(), 1);
+		const int32 PageIndex = GetNewPageIndex(View.CurrentPageIndex);
+		View.CurrentPageIndex = ((PageIndex % NumPages) + NumPages) % NumPages;
+	};
+
+	// without a game viewport, all viewports change the page
+	if (FViewState* View = FindViewForWorld(World))
+	{
+		ChangeViewPage(*View);
+	}
+	else
+	{
+		for (auto& Itr : ViewStates)
+		{
+			ChangeViewPage(Itr.Value);
+		}
+	}
+
+	// rows on the new page weren't evaluated, refresh them right away
+	for (FPresetState& PresetState : PresetStates)
+	{
+		PresetState.NextRefreshTime = 0.;
+	}
+}
+
+void FQuickStatsRenderer::SetPage_Command(UWorld* World, int32 PageIndex)
+{
+	ChangePage(World, [PageIndex](int32 CurrentPageIndex) { return PageIndex; });
+}
+
+void FQuickStatsRenderer::NextPage_Command(UWorld* World)
+{
+	ChangePage(World, [](int32 CurrentPageIndex) { return CurrentPageIndex + 1; });
+}
+
+void FQuickStatsRenderer::PreviousPage_Command(UWorld* World)
+{
+	ChangePage(World, [](int32 CurrentPageIndex) { return CurrentPageIndex - 1; });
+}
+
+void FQuickStatsRenderer::WriteSessionReport_Command(const FString& BaseFilePath)
+{
+	if (!SessionReport)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Session report is disabled, enable RecordSessionReport in QuickStatSettings or run with -qstatsreport."));
+		return;
+	}
+
+	SessionReport->WriteReport(BaseFilePath.IsEmpty() ? FQuickStatsSessionReport::GetDefaultReportPath() : BaseFilePath);
+}
+
+void FQuickStatsRenderer::ExportHeatmap_Command()
+{
+	if (!Heatmap)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Heatmap is disabled, enable RecordHeatmap in QuickStatSettings or run with -qstatsheatmap."));
+		return;
+	}
+
+	Heatmap->Export();
+}
+
+void FQuickStatsRenderer::UpdateHeatmapLocation()
+{
+	for (const FWorldContext& WorldContext : GEngine->GetWorldContexts())
+	{
+		UWorld* World = WorldContext.World();
+		if (World && World->IsGameWorld())
+		{
+			const APlayerController* PlayerController = GEngine->GetFirstLocalPlayerController(World);
+			if (PlayerController)
+			{
+				FVector Location;
+				FRotator Rotation;
+				PlayerController->GetPlayerViewPoint(Location, Rotation);
+				Heatmap->SetViewLocation(Location);
+				return;
+			}
+		}
+	}
+}
+
+void FQuickStatsRenderer::Correlate_Command(int32 NumContributors)
+{
+	if (!Correlation)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Correlation is disabled, enable AnalyzeCorrelation in QuickStatSettings."));
+		return;
+	}
+
+	Correlation->LogTopContributors(FMath::Max(NumContributors, 1));
+}
+
+void FQuickStatsRenderer::SetCorrelationTarget_Command(const FString& TargetName)
+{
+	if (!Correlation)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Correlation is disabled, enable AnalyzeCorrelation in QuickStatSettings."));
+		return;
+	}
+
+	Correlation->SetTarget(TargetName);
+}
+
+void FQuickStatsRenderer::LoadBaseline_Command(const FString& FilePath)
+{
+	LoadBaseline(FilePath == TEXT("None") ? FString() : FilePath);
+}
+
+void FQuickStatsRenderer::CheckBaseline_Command()
+{
+	if (!Baseline || !SessionReport)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Checking baseline needs a baseline (qstats.Baseline) and RecordSessionReport enabled in QuickStatSettings (or -qstatsreport)."));
+		return;
+	}
+
+	CheckBaseline(GetDefault<UQuickStatSettings>(), *SessionReport);
+}
+
+void FQuickStatsRenderer::LoadBaseline(const FString& FilePath)
+{
+	Baseline.Reset();
+	if (!FilePath.IsEmpty())
+	{
+		// relative paths are relative to the project
+		Baseline = FQuickStatsBaseline::Load(FPaths::IsRelative(FilePath) ? FPaths::Combine(FPaths::ProjectDir(), FilePath) : FilePath);
+	}
+
+	// baseline values are cached by stat states
+	bStatStatesDirty = true;
+}
+
+double FQuickStatsRenderer::GetRegressionTolerance(const UQuickStatSettings* Settings, const FQuickStat& Stat)
+{
+	return ((Stat.RegressionTolerance > 0.f) ? Stat.RegressionTolerance : Settings->BaselineTolerance) / 100.;
+}
+
+double FQuickStatsRenderer::GetAbsoluteRegressionTolerance(const UQuickStatSettings* Settings, const FQuickStat& Stat)
+{
+	return (Stat.RegressionAbsoluteTolerance > 0.f) ? Stat.RegressionAbsoluteTolerance : Settings->BaselineAbsoluteTolerance;
+}
+
+void FQuickStatsRenderer::DetectAnomaly(const UQuickStatSettings* Settings, FStatState& StatState, uint64 FrameNumber, double FrameTime)
+{
+	if (!StatState.AnomalyDetector.IsSet())
+	{
+		return;
+	}
+
+	FQuickStatsAnomalyDetector& Detector = StatState.AnomalyDetector.GetValue();
+	const double Mean = Detector.GetMean();
+	const EQuickStatsAnomaly Anomaly = Detector.Add(StatState.FrameValue);
+	if (Anomaly == EQuickStatsAnomaly::None)
+	{
+		return;
+	}
+
+	// repeated spikes of a highlighted stat aren't logged again, level shifts always are
+	const bool bIsHighlighted = (FrameTime - StatState.LastAnomalyTime < Settings->AnomalyHighlightDuration);
+	if (Anomaly == EQuickStatsAnomaly::LevelShift || !bIsHighlighted)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] %s of %s/%s at frame %llu: %.4g (mean %.4g, z %+.1f)"),
+			(Anomaly == EQuickStatsAnomaly::LevelShift) ? TEXT("Level shift") : TEXT("Spike"),
+			*PresetStates[StatState.PresetIndex].PresetName.ToString(), *StatState.Stat->StatDescription, FrameNumber, StatState.FrameValue, Mean, Detector.GetScore());
+	}
+	StatState.LastAnomalyTime = FrameTime;
+}
+
+FQuickStatsRenderer::FBaselineCheck FQuickStatsRenderer::CheckBaseline(const UQuickStatSettings* Settings, const FQuickStatsSessionReport& Report)
+{
+	FBaselineCheck Check;
+
+	// every stat of the baseline has to be evaluated, a renamed or removed stat would pass the gate otherwise
+	TArray<TPair<FName, FString>> BaselineStatNames;
+	Baseline->GetStatNames(BaselineStatNames);
+
+	for (const TPair<FName, FString>& StatName : BaselineStatNames)
+	{
+		const UQuickStatPreset* StatPreset = Settings->GetPresetByName(StatName.Key);
+		const FQuickStat* Stat = StatPreset ? StatPreset->StatsToDisplay.FindByPredicate([&StatName](const FQuickStat& PresetStat) { return PresetStat.StatDescription == StatName.Value; }) : nullptr;
+		const FQuickStatsSummary* Summary = Report.FindSummary(StatName.Key, StatName.Value);
+		if (!Stat || !Summary || Summary->NumFrames == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] %s/%s of the baseline wasn't evaluated in this session"), *StatName.Key.ToString(), *StatName.Value);
+			Check.NumMissingStats++;
+			continue;
+		}
+
+		double BaselineValue;
+		Baseline->FindValue(StatName.Key, StatName.Value, Settings->BaselineMetric, BaselineValue);
+		Check.NumComparedStats++;
+
+		const double Value = FQuickStatsBaseline::GetSummaryValue(*Summary, Settings->BaselineMetric);
+		if (FQuickStatsBaseline::GetToleranceRatio(Value, BaselineValue, GetRegressionTolerance(Settings, *Stat), GetAbsoluteRegressionTolerance(Settings, *Stat)) > 1.)
 		{
-			SetEnabledPresets(NewPresets);
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] %s/%s regressed: %.4f -> %.4f (%+.4f, %+.1f%%)"), *StatName.Key.ToString(), *StatName.Value, BaselineValue, Value,
+				Value - BaselineValue, FQuickStatsBaseline::GetRelativeDelta(Value, BaselineValue) * 100.);
+			Check.NumRegressedStats++;
 		}
 	}
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] %d of %d stats regressed from baseline %s, %d stats of the baseline weren't evaluated"),
+		Check.NumRegressedStats, Check.NumComparedStats, *Baseline->GetFilePath(), Check.NumMissingStats);
+	return Check;
 }
 
 #endif // #if STATS
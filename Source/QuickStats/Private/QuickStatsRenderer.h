@@ -7,10 +7,54 @@
 #if STATS
 
 #include "ConsoleSettings.h"
+#include "QuickStatsAnomalyDetector.h"
+#include "QuickStatExpressions.h"
+#include "QuickStatsFeed.h"
 
 class FCanvas;
+struct FCanvasUVTri;
 class FViewport;
+class FViewportClient;
 class FCommonViewportClient;
+class UGameViewportClient;
+class UQuickStatSettings;
+class UFont;
+class SQuickStatsOverlay;
+class FQuickStatsCollector;
+class FQuickStatsSessionReport;
+class FQuickStatsBaseline;
+class FQuickStatsCorrelation;
+class FQuickStatsHeatmap;
+struct FQuickStat;
+
+struct FQuickStatsBarSegment
+{
+	// share of the bar width
+	float Fraction = 0.f;
+	FColor Color = FColor::White;
+	// stat is over its own budget, segment is outlined
+	bool bIsOverBudget = false;
+
+	bool operator==(const FQuickStatsBarSegment& Other) const { return Fraction == Other.Fraction && Color == Other.Color && bIsOverBudget == Other.bIsOverBudget; }
+	bool operator!=(const FQuickStatsBarSegment& Other) const { return !(*this == Other); }
+};
+
+struct FQuickStatsRow
+{
+	// Preset name or stat description
+	FString Text;
+	FString ValueText;
+	FColor Color = FColor::White;
+	// Preset names (and messages) don't have a value column
+	bool bIsPresetName = false;
+	// color of the stat in its preset's stacked bar, transparent for stats of presets displayed as rows
+	FColor SegmentColor = FColor::Transparent;
+	// stacked bar drawn in place of the text, its value is the total
+	bool bIsBar = false;
+	TArray<FQuickStatsBarSegment> BarSegments;
+	// position of the budget marker as a fraction of the bar width, negative without a budget
+	float BarBudgetFraction = -1.f;
+};
 
 class FQuickStatsRenderer
 {
@@ -18,25 +62,263 @@ public:
 	static void RegisterStatPresets();
 	static void UnregisterStatPresets();
 
+	// Commands apply to the game viewport of the World, or to the default presets if World doesn't have one (editor, commandline).
+
 	// disable all the stats and enable these
-	static void SetPresets_Command(const TArray<FName>& PresetNames);
+	static void SetPresets_Command(UWorld* World, const TArray<FName>& PresetNames);
 
 	// add this preset to the enabled list
-	static void EnablePresets_Command(const TArray<FName>& PresetNames);
+	static void EnablePresets_Command(UWorld* World, const TArray<FName>& PresetNames);
 
 	// remove this preset from the enabled list
-	static void DisablePresets_Command(const TArray<FName>& PresetNames);
+	static void DisablePresets_Command(UWorld* World, const TArray<FName>& PresetNames);
+
+	// move to the page, wraps around the number of pages
+	static void SetPage_Command(UWorld* World, int32 PageIndex);
+	static void NextPage_Command(UWorld* World);
+	static void PreviousPage_Command(UWorld* World);
+
+	// write summary of the session, default path is used if BaseFilePath is empty
+	static void WriteSessionReport_Command(const FString& BaseFilePath);
+
+	// write the heatmap recorded so far
+	static void ExportHeatmap_Command();
+
+	// log stats most correlated with the correlation target
+	static void Correlate_Command(int32 NumContributors);
+	static void SetCorrelationTarget_Command(const FString& TargetName);
+
+	// compare stats against a session report of an earlier run, None unloads the baseline
+	static void LoadBaseline_Command(const FString& FilePath);
+
+	// log stats of the session which regressed from the baseline
+	static void CheckBaseline_Command();
+
+private:
+	struct FPresetState
+	{
+		FName PresetName = NAME_None;
+		int32 FirstStatIndex = 0;
+		int32 NumStats = 0;
+
+		// seconds between refreshes, 0 refreshes every frame
+		double RefreshInterval = 0.;
+		double NextRefreshTime = 0.;
+		bool bRefreshThisFrame = false;
+
+		// stats are drawn as a stacked bar against BarBudget
+		bool bIsStackedBar = false;
+		double BarBudget = 0.;
+		// displayed total of the stacked bar, RefreshCount is used by viewports to detect changes
+		FString BarValueText;
+		FColor BarColor = FColor::Magenta;
+		TArray<FQuickStatsBarSegment> BarSegments;
+		float BarBudgetFraction = -1.f;
+		uint32 RefreshCount = 0;
+	};
+
+	// Evaluation state of a stat, shared by all the viewports displaying it
+	struct FStatState
+	{
+		const FQuickStat* Stat = nullptr;
+		int32 PresetIndex = INDEX_NONE;
+		// any viewport displays this stat on current page
+		bool bIsVisible = true;
+		// any active feed needs value of this stat
+		bool bIsRequiredByFeeds = false;
+
+		// value evaluated this frame, NaN if the stat couldn't be evaluated
+		// sampled stats keep their last sample between evaluations
+		double FrameValue = 0.;
+		// seconds between evaluations, 0 evaluates every frame
+		double SamplingPeriod = 0.;
+
+		// value of the stat in the baseline, NaN if it's not in the baseline
+		double BaselineValue = 0.;
+		// allowed relative increase over the baseline, increases below the absolute tolerance are always allowed
+		double RegressionTolerance = 0.;
+		double AbsoluteRegressionTolerance = 0.;
+
+		// only set for stats with DetectAnomalies
+		TOptional<FQuickStatsAnomalyDetector> AnomalyDetector;
+		// frame time of the last anomaly, the row stays highlighted for AnomalyHighlightDuration
+		double LastAnomalyTime = TNumericLimits<double>::Lowest();
+
+		// values evaluated since last refresh
+		double AccumulatedValue = 0.;
+		int32 NumAccumulatedValues = 0;
+
+		// displayed values, RefreshCount is used by viewports to detect changes
+		FString ValueText = TEXT("N/A");
+		FColor Color = FColor::Magenta;
+		uint32 RefreshCount = 0;
+		// value and unit of ValueText, NaN if not available
+		double DisplayValue = 0.;
+		EQuickStatUnit DisplayUnit = EQuickStatUnit::Count;
+	};
+
+	struct FScheduledSample
+	{
+		double NextSampleTime = 0.;
+		int32 StatIndex = INDEX_NONE;
+
+		// min heap on next sample time
+		bool operator<(const FScheduledSample& Other) const { return NextSampleTime < Other.NextSampleTime; }
+	};
+
+	struct FRowBinding
+	{
+		// INDEX_NONE for preset names
+		int32 StatIndex = INDEX_NONE;
+		// preset of a stacked bar row, INDEX_NONE for other rows
+		int32 BarPresetIndex = INDEX_NONE;
+		uint32 RefreshCount = 0;
+	};
+
+	struct FRowLayout
+	{
+		// relative to the stats origin
+		FIntPoint TextPosition = FIntPoint::ZeroValue;
+		FIntPoint ValuePosition = FIntPoint::ZeroValue;
+		int32 ColumnIndex = INDEX_NONE;
+		int32 PageIndex = INDEX_NONE;
+		// length of value text when it was last measured
+		int32 MeasuredValueLength = INDEX_NONE;
+	};
+
+	struct FColumnLayout
+	{
+		int32 FirstRow = 0;
+		int32 NumRows = 0;
+		int32 ValueColumnWidth = 0;
+	};
+
+	struct FPageLayout
+	{
+		int32 FirstRow = 0;
+		int32 NumRows = 0;
+		// background size including padding
+		FIntPoint Size = FIntPoint::ZeroValue;
+	};
+
+	struct FStatsLayout
+	{
+		TArray<FRowLayout> Rows;
+		TArray<FColumnLayout> Columns;
+		TArray<FPageLayout> Pages;
+
+		// inputs used to compute the layout
+		TWeakObjectPtr<const UFont> Font;
+		FIntPoint ViewportSize = FIntPoint::ZeroValue;
+		FIntPoint Origin = FIntPoint::ZeroValue;
+		bool bDirty = true;
+	};
+
+	// Headless benchmark started from commandline (-qstatsbench)
+	struct FBenchmarkState
+	{
+		TArray<FName> Presets;
+		// engine frames skipped before recording
+		int32 NumWarmupFrames = 0;
+		// evaluated frames recorded in the report
+		int32 NumFrames = 0;
+		// report path without extension, default path is used if empty
+		FString OutputPath;
+		bool bIsRunning = false;
+	};
+
+	struct FBaselineCheck
+	{
+		int32 NumComparedStats = 0;
+		int32 NumRegressedStats = 0;
+		// stats of the baseline that weren't evaluated in this session
+		int32 NumMissingStats = 0;
+	};
+
+	// Presets and display state of a viewport
+	struct FViewState
+	{
+		TArray<FName> EnabledPresets;
+		// viewport follows default presets until presets are set for it
+		bool bUseDefaultPresets = true;
+		// follows the stat toggle of the viewport, not whether it rendered this frame
+		bool bIsRenderingStats = false;
+
+		// the view is removed once its viewport client is destroyed, views of other clients are kept
+		TWeakObjectPtr<UGameViewportClient> GameViewportClient;
+		bool bIsEditorViewport = false;
+
+		// rows are cached between refreshes and only rebuilt when presets change
+		TArray<FQuickStatsRow> StatRows;
+		TArray<FRowBinding> RowBindings;
+		int32 NumStatRows = 0;
+		bool bStatRowsDirty = true;
+
+		FStatsLayout Layout;
+		int32 CurrentPageIndex = 0;
+
+		TSharedPtr<SQuickStatsOverlay> Overlay;
+		TWeakObjectPtr<UGameViewportClient> OverlayViewportClient;
+	};
 
 private:
 	static int32 OnRenderStats(UWorld* World, FViewport* Viewport, FCanvas* Canvas, int32 X, int32 Y, const FVector* ViewLocation, const FRotator* ViewRotation);
 	static bool OnToggleStats(UWorld* World, FCommonViewportClient* ViewportClient, const TCHAR* Stream);
 	static void PopulateAutoCompletePresetNames(TArray<FAutoCompleteCommand>& AutoCompleteList);
+	// stats frames are consumed even if viewports didn't render stats this frame
+	static void OnEndFrame();
+	// removes views of destroyed viewport clients, so a new client allocated at the same address doesn't inherit them
+	static void RemoveClosedViews();
+	static void OnPreExit();
 	static void OnObjectPropertyChanged(UObject* InObject, FPropertyChangedEvent& InChangeEvent);
 
 	// helpers
-	static void SetEnabledPresets(TArray<FName> NewPresets);
-	static void EnableStatGroup(FName StatGroupName);
-	static void DisableStatGroup(FName StatGroupName);	
+	// returns view of the World's game viewport, nullptr if World doesn't have one
+	static FViewState* FindViewForWorld(UWorld* World);
+	static FViewState& FindOrAddView(const FViewportClient* ViewportClient, UWorld* World);
+	static const TArray<FName>& GetViewPresets(const FViewState& View);
+	// rebuilds evaluated stats from presets of all the viewports rendering stats
+	static void RebuildStatStates(const UQuickStatSettings* Settings);
+	// evaluates stats that are due for refresh, only once per frame for all the viewports
+	static void EvaluateStats(const UQuickStatSettings* Settings);
+	// rebuilds rows of the viewport, returns false if its presets don't have any stat to display
+	static bool UpdateViewRows(const UQuickStatSettings* Settings, FViewState& View);
+	// measures rows and packs them into columns and pages fitting the viewport, full layout pass only runs if rows, font or viewport size changed
+	static void UpdateStatsLayout(const UQuickStatSettings* Settings, FViewState& View, const UFont* Font, FIntPoint ViewportSize, FIntPoint Origin);
+	// rows outside current page are not evaluated unless they have a budget
+	static bool IsStatRowVisible(const FViewState& View, int32 RowIndex);
+	// adds quads of the preset's stacked bar, bars and swatches of all the rows are drawn in a single batch
+	static void AddStackedBar(TArray<FCanvasUVTri>& Triangles, const FQuickStatsRow& BarRow, FVector2D Position, float Width, float Height);
+	// "Page 1/2" footer of paged views, red if stats on other pages are over budget
+	static FQuickStatsRow GetPageFooter(const FViewState& View, int32 PageIndex);
+	static FColor GetSegmentColor(int32 SegmentIndex);
+	static TSharedPtr<SQuickStatsOverlay> FindOrCreateOverlay(FViewState& View, UWorld* World, FViewport* Viewport);
+	static void RemoveOverlay(FViewState& View);
+	static void ChangePage(UWorld* World, TFunctionRef<int32(int32 CurrentPageIndex)> GetNewPageIndex);
+	static void SetEnabledPresets(UWorld* World, TArray<FName> NewPresets);
+	// collects stats read by presets of all the viewports rendering stats
+	static void UpdateCollectedStats();
+	// presets of all the viewports rendering stats and the benchmark, returns false if nothing is evaluated
+	static bool GetEvaluatedPresets(TArray<FName>& OutPresetNames);
+	// comma separated list of presets, undefined presets are skipped
+	static void ParsePresetNames(const UQuickStatSettings* Settings, const FString& PresetList, TArray<FName>& OutPresetNames);
+	// skips warmup frames, then records the report and exits once enough frames are evaluated
+	static void UpdateBenchmark();
+	// recreates feeds according to settings
+	static void UpdateFeeds(const UQuickStatSettings* Settings);
+	static void PublishFeedSchema(const UQuickStatSettings* Settings);
+	static void LoadBaseline(const FString& FilePath);
+	static double GetRegressionTolerance(const UQuickStatSettings* Settings, const FQuickStat& Stat);
+	static double GetAbsoluteRegressionTolerance(const UQuickStatSettings* Settings, const FQuickStat& Stat);
+	// location of the first local player for frames no viewport rendered stats (-nullrhi fly-throughs)
+	static void UpdateHeatmapLocation();
+	// feeds the evaluated value to the anomaly detector of the stat, logs and highlights anomalies
+	static void DetectAnomaly(const UQuickStatSettings* Settings, FStatState& StatState, uint64 FrameNumber, double FrameTime);
+	// compares every stat of the baseline with the report, logs regressed and missing stats
+	static FBaselineCheck CheckBaseline(const UQuickStatSettings* Settings, const FQuickStatsSessionReport& Report);
+	// checks the report against the baseline once per run, returns the exit code
+	// (1 if the report is missing, nothing was compared, or any stat regressed or is missing from the report)
+	static uint8 RunRegressionGate(const UQuickStatSettings* Settings, const FQuickStatsSessionReport* Report);
 
 private:
 	static const FName QuickStatsPresetName;
@@ -45,11 +327,48 @@ private:
 
 	static FDelegateHandle ConsoleAutoCompleteHandle;
 	static FDelegateHandle OnObjectPropertyChangedHandle;
+	static FDelegateHandle OnEndFrameHandle;
+	static FDelegateHandle OnPreExitHandle;
 
-	static bool bIsRenderingStats;
+	// presets used by viewports which didn't choose their own
 	static TArray<FName> EnabledPresets;
-	// StatExpression can change when modifying Presets, so need to keep track of enabled statgroups.
-	static TSet<FName> EnabledStatGroups;
+	// aggregates stats read by enabled presets on the stats thread
+	static TUniquePtr<FQuickStatsCollector> StatsCollector;
+
+	static TMap<const FViewportClient*, FViewState> ViewStates;
+
+	// union of presets displayed by all the viewports, evaluated once per frame
+	static bool bStatStatesDirty;
+	static uint64 LastEvaluatedFrameNumber;
+	static TArray<FPresetState> PresetStates;
+	static TArray<FStatState> StatStates;
+	// stats evaluated every frame, others are evaluated when due in SampleSchedule
+	static TArray<int32> EveryFrameStatIndices;
+	static TArray<FScheduledSample> SampleSchedule;
+
+	// feeds need values of all the stats every frame, not just the visible ones
+	static TArray<TUniquePtr<IQuickStatsFeed>> Feeds;
+	static TArray<double> FeedValues;
+	static TArray<IQuickStatsFeed*> ActiveFeeds;
+	// schema last published, feeds are only notified when it changes or when they are new
+	static TArray<FQuickStatsFeedStat> PublishedFeedStats;
+	static TArray<const IQuickStatsFeed*> PublishedFeeds;
+	// owned by Feeds
+	static FQuickStatsSessionReport* SessionReport;
+	// owned by Feeds
+	static FQuickStatsCorrelation* Correlation;
+	static FQuickStatsHeatmap* Heatmap;
+	// frame the heatmap location was last set by a rendering viewport
+	static uint64 HeatmapLocationFrameNumber;
+	static TUniquePtr<FQuickStatsBaseline> Baseline;
+
+	static FBenchmarkState Benchmark;
+	// owned by Feeds, created once benchmark warmup is over
+	static FQuickStatsSessionReport* BenchmarkReport;
+	// exit code has to be requested while the main loop still runs, so the gate runs before PreExit
+	static bool bRegressionGateChecked;
+	// unattended or -nullrhi run with a baseline, the session is recorded and enabled presets are evaluated without a viewport
+	static bool bIsHeadlessGate;
 };
 
 #endif //#if STATS
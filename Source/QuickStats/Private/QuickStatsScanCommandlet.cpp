@@ -0,0 +1,73 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsScanCommandlet.h"
+#include "QuickStatsCaptureReader.h"
+#include "QuickStatsSummary.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UQuickStatsScanCommandlet::UQuickStatsScanCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UQuickStatsScanCommandlet::Main(const FString& Params)
+{
+	FString CaptureDirectory;
+	FString PresetName;
+	FString StatDescription;
+	if (!FParse::Value(*Params, TEXT("Captures="), CaptureDirectory) || !FParse::Value(*Params, TEXT("Preset="), PresetName) || !FParse::Value(*Params, TEXT("Stat="), StatDescription))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[QuickStat] Usage: -run=QuickStatsScan -Captures=<Directory> -Preset=<PresetName> -Stat=\"<StatDescription>\" [-Out=<File.csv>]"));
+		return 1;
+	}
+
+	FString OutputPath;
+	FParse::Value(*Params, TEXT("Out="), OutputPath);
+
+	TArray<FString> FilePaths;
+	IFileManager::Get().FindFilesRecursive(FilePaths, *CaptureDirectory, *(FString(TEXT("*")) + ANSI_TO_TCHAR(QuickStatsCapture::FileExtension)), true, false);
+	FilePaths.Sort();
+
+	FString Csv = TEXT("File,StartTime,Frames,Min,Max,Mean,P50,P95,P99,OverBudgetFrames\n");
+	int32 NumScannedCaptures = 0;
+
+	// captures are opened one at a time, memory doesn't grow with the number of captures
+	for (const FString& FilePath : FilePaths)
+	{
+		TUniquePtr<FQuickStatsCaptureReader> Reader = FQuickStatsCaptureReader::Open(FilePath);
+		const int32 StatIndex = Reader ? Reader->FindStat(FName(*PresetName), StatDescription) : INDEX_NONE;
+		if (StatIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		FQuickStatsSummary Summary;
+		const double Budget = Reader->GetBudget(StatIndex);
+		if (!Reader->ForEachStatValue(StatIndex, [&Summary, Budget](int32 FrameIndex, double Value) { Summary.Add(Value, Budget); }) || Summary.NumFrames == 0)
+		{
+			continue;
+		}
+
+		const FString Row = FString::Printf(TEXT("\"%s\",%s,%lld,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%lld"), *FPaths::GetCleanFilename(FilePath), *Reader->GetStartTime().ToIso8601(),
+			Summary.NumFrames, Summary.Min, Summary.Max, Summary.GetMean(), Summary.P50.Get(), Summary.P95.Get(), Summary.P99.Get(), Summary.NumOverBudgetFrames);
+		UE_LOG(LogTemp, Display, TEXT("[QuickStat] %s"), *Row);
+
+		Csv += Row + TEXT("\n");
+		NumScannedCaptures++;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("[QuickStat] %s/%s found in %d of %d captures"), *PresetName, *StatDescription, NumScannedCaptures, FilePaths.Num());
+
+	if (!OutputPath.IsEmpty() && !FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[QuickStat] Failed to write %s"), *OutputPath);
+		return 1;
+	}
+	return 0;
+}
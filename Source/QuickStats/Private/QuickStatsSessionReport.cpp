@@ -0,0 +1,148 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsSessionReport.h"
+
+#if STATS
+
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FQuickStatsSessionReport::FQuickStatsSessionReport()
+	: SessionStartTime(FDateTime::Now())
+{
+}
+
+void FQuickStatsSessionReport::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	RecordIndices.Reset(Stats.Num());
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		int32 RecordIndex = Records.IndexOfByPredicate([&Stat](const FStatRecord& Record) { return Record.PresetName == Stat.PresetName && Record.StatDescription == Stat.StatDescription; });
+		if (RecordIndex == INDEX_NONE)
+		{
+			RecordIndex = Records.AddDefaulted();
+			Records[RecordIndex].PresetName = Stat.PresetName;
+			Records[RecordIndex].StatDescription = Stat.StatDescription;
+		}
+
+		Records[RecordIndex].Budget = Stat.Budget;
+		RecordIndices.Add(RecordIndex);
+	}
+}
+
+void FQuickStatsSessionReport::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (Values.Num() != RecordIndices.Num())
+	{
+		return;
+	}
+
+	for (int32 StatIndex = 0; StatIndex < Values.Num(); ++StatIndex)
+	{
+		FStatRecord& Record = Records[RecordIndices[StatIndex]];
+		Record.Summary.Add(Values[StatIndex], Record.Budget);
+	}
+
+	if (NumFrames == 0)
+	{
+		FirstFrameTime = Time;
+	}
+	LastFrameTime = Time;
+	NumFrames++;
+}
+
+bool FQuickStatsSessionReport::WriteReport(const FString& BaseFilePath) const
+{
+	if (NumFrames == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[QuickStat] No frames were recorded, session report is not written."));
+		return false;
+	}
+
+	const FString JsonFilePath = BaseFilePath + TEXT(".json");
+	const FString CsvFilePath = BaseFilePath + TEXT(".csv");
+	if (!FFileHelper::SaveStringToFile(ToJson(), *JsonFilePath) || !FFileHelper::SaveStringToFile(ToCsv(), *CsvFilePath))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write session report %s"), *BaseFilePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[QuickStat] Session report (%lld frames) written to %s"), NumFrames, *JsonFilePath);
+	return true;
+}
+
+const FQuickStatsSummary* FQuickStatsSessionReport::FindSummary(FName PresetName, const FString& StatDescription) const
+{
+	const FStatRecord* Record = Records.FindByPredicate([&](const FStatRecord& StatRecord) { return StatRecord.PresetName == PresetName && StatRecord.StatDescription == StatDescription; });
+	return Record ? &Record->Summary : nullptr;
+}
+
+FString FQuickStatsSessionReport::GetDefaultReportPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("QuickStats") / TEXT("Reports") / FString::Printf(TEXT("Session_%s"), *FDateTime::Now().ToString());
+}
+
+FString FQuickStatsSessionReport::ToJson() const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("StartTime"), SessionStartTime.ToIso8601());
+	Root->SetNumberField(TEXT("Duration"), LastFrameTime - FirstFrameTime);
+	Root->SetNumberField(TEXT("Frames"), NumFrames);
+
+	TArray<TSharedPtr<FJsonValue>> StatValues;
+	for (const FStatRecord& Record : Records)
+	{
+		const FQuickStatsSummary& Summary = Record.Summary;
+
+		TSharedRef<FJsonObject> StatObject = MakeShared<FJsonObject>();
+		StatObject->SetStringField(TEXT("Preset"), Record.PresetName.ToString());
+		StatObject->SetStringField(TEXT("Stat"), Record.StatDescription);
+		StatObject->SetNumberField(TEXT("Budget"), Record.Budget);
+		StatObject->SetNumberField(TEXT("Frames"), Summary.NumFrames);
+
+		// stats that were never valid only report their frame count
+		if (Summary.NumFrames > 0)
+		{
+			StatObject->SetNumberField(TEXT("Min"), Summary.Min);
+			StatObject->SetNumberField(TEXT("Max"), Summary.Max);
+			StatObject->SetNumberField(TEXT("Mean"), Summary.GetMean());
+			StatObject->SetNumberField(TEXT("P50"), Summary.P50.Get());
+			StatObject->SetNumberField(TEXT("P95"), Summary.P95.Get());
+			StatObject->SetNumberField(TEXT("P99"), Summary.P99.Get());
+			StatObject->SetNumberField(TEXT("OverBudgetFrames"), Summary.NumOverBudgetFrames);
+		}
+
+		StatValues.Add(MakeShared<FJsonValueObject>(StatObject));
+	}
+	Root->SetArrayField(TEXT("Stats"), StatValues);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Json;
+}
+
+FString FQuickStatsSessionReport::ToCsv() const
+{
+	FString Csv = TEXT("Preset,Stat,Budget,Frames,Min,Max,Mean,P50,P95,P99,OverBudgetFrames\n");
+	for (const FStatRecord& Record : Records)
+	{
+		const FQuickStatsSummary& Summary = Record.Summary;
+
+		Csv += FString::Printf(TEXT("\"%s\",\"%s\",%.4f,%lld"), *Record.PresetName.ToString(), *Record.StatDescription.Replace(TEXT("\""), TEXT("\"\"")), Record.Budget, Summary.NumFrames);
+		if (Summary.NumFrames > 0)
+		{
+			Csv += FString::Printf(TEXT(",%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%lld\n"), Summary.Min, Summary.Max, Summary.GetMean(), Summary.P50.Get(), Summary.P95.Get(), Summary.P99.Get(), Summary.NumOverBudgetFrames);
+		}
+		else
+		{
+			Csv += TEXT(",,,,,,,\n");
+		}
+	}
+	return Csv;
+}
+
+#endif //#if STATS
@@ -0,0 +1,59 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+#include "QuickStatsSummary.h"
+
+/*
+* Summarizes every evaluated stat over the session (min, max, mean, p50/p95/p99, frames over budget).
+* Memory only depends on the number of stats, not on the length of the session.
+*/
+class FQuickStatsSessionReport : public IQuickStatsFeed
+{
+public:
+	FQuickStatsSessionReport();
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+	// writes BaseFilePath.json and BaseFilePath.csv, returns false if nothing was recorded or files couldn't be written
+	bool WriteReport(const FString& BaseFilePath) const;
+
+	int64 GetNumFrames() const { return NumFrames; }
+
+	// nullptr if the stat was never evaluated
+	const FQuickStatsSummary* FindSummary(FName PresetName, const FString& StatDescription) const;
+
+	// Saved/QuickStats/Reports/Session_<date>
+	static FString GetDefaultReportPath();
+
+private:
+	struct FStatRecord
+	{
+		FName PresetName = NAME_None;
+		FString StatDescription;
+		double Budget = 0.;
+		FQuickStatsSummary Summary;
+	};
+
+	FString ToJson() const;
+	FString ToCsv() const;
+
+private:
+	// every stat evaluated during the session, stats stay in the report when presets are disabled
+	TArray<FStatRecord> Records;
+	// record of each stat in the schema
+	TArray<int32> RecordIndices;
+
+	FDateTime SessionStartTime;
+	double FirstFrameTime = 0.;
+	double LastFrameTime = 0.;
+	int64 NumFrames = 0;
+};
+
+#endif //#if STATS
@@ -0,0 +1,116 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsSharedMemoryFeed.h"
+
+#if STATS
+
+#include "QuickStatsFeedLayout.h"
+
+// long names are cut on a code point boundary, so readers never get a partial utf-8 sequence
+static void CopyName(char (&Destination)[QuickStatsFeed::MaxNameLength], const FString& Name)
+{
+	const FTCHARToUTF8 Utf8Name(*Name);
+	int32 Length = FMath::Min<int32>(Utf8Name.Length(), QuickStatsFeed::MaxNameLength - 1);
+	if (Length < Utf8Name.Length())
+	{
+		// continuation bytes (10xxxxxx) belong to the code point before the cut
+		while (Length > 0 && (static_cast<uint8>(Utf8Name.Get()[Length]) & 0xC0) == 0x80)
+		{
+			Length--;
+		}
+	}
+
+	FMemory::Memcpy(Destination, Utf8Name.Get(), Length);
+	Destination[Length] = 0;
+}
+
+FQuickStatsSharedMemoryFeed::FQuickStatsSharedMemoryFeed()
+{
+	const uint32 AccessMode = static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Read) | static_cast<uint32>(FPlatformMemory::ESharedMemoryAccess::Write);
+	SharedMemoryRegion = FPlatformMemory::MapNamedSharedMemoryRegion(FString(QuickStatsFeed::RegionName), true, AccessMode, sizeof(QuickStatsFeed::FRegion));
+	if (!SharedMemoryRegion)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to create shared memory region(%s), stats won't be published."), ANSI_TO_TCHAR(QuickStatsFeed::RegionName));
+		return;
+	}
+
+	Region = new (SharedMemoryRegion->GetAddress()) QuickStatsFeed::FRegion();
+	Region->Header.Version = QuickStatsFeed::Version;
+	Region->Header.MaxStats = QuickStatsFeed::MaxStats;
+	Region->Header.MaxFrames = QuickStatsFeed::MaxFrames;
+	Region->Header.WriterProcessId = FPlatformProcess::GetCurrentProcessId();
+
+	// readers ignore the region until magic is set
+	Region->Header.Magic.store(QuickStatsFeed::Magic, std::memory_order_release);
+}
+
+FQuickStatsSharedMemoryFeed::~FQuickStatsSharedMemoryFeed()
+{
+	if (SharedMemoryRegion)
+	{
+		Region->Header.Magic.store(0, std::memory_order_release);
+		Region = nullptr;
+
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(SharedMemoryRegion);
+		SharedMemoryRegion = nullptr;
+	}
+}
+
+void FQuickStatsSharedMemoryFeed::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	if (!Region)
+	{
+		return;
+	}
+
+	QuickStatsFeed::FSchema& Schema = Region->Schema;
+
+	const uint64 Sequence = Schema.Sequence.load(std::memory_order_relaxed);
+	Schema.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (Stats.Num() > (int32)QuickStatsFeed::MaxStats)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Only first %u of %d stats are published to shared memory."), QuickStatsFeed::MaxStats, Stats.Num());
+	}
+
+	Schema.NumStats = FMath::Min<uint32>(Stats.Num(), QuickStatsFeed::MaxStats);
+	for (uint32 StatIndex = 0; StatIndex < Schema.NumStats; ++StatIndex)
+	{
+		const FQuickStatsFeedStat& Stat = Stats[StatIndex];
+		QuickStatsFeed::FStatSchema& StatSchema = Schema.Stats[StatIndex];
+
+		StatSchema.Budget = Stat.Budget;
+		CopyName(StatSchema.PresetName, Stat.PresetName.ToString());
+		CopyName(StatSchema.StatDescription, Stat.StatDescription);
+	}
+
+	Schema.Sequence.store(Sequence + 2, std::memory_order_release);
+}
+
+void FQuickStatsSharedMemoryFeed::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (!Region)
+	{
+		return;
+	}
+
+	// single writer, so relaxed loads of our own counters are fine
+	const uint64 FrameIndex = Region->Header.NumFramesWritten.load(std::memory_order_relaxed);
+	QuickStatsFeed::FFrame& Frame = Region->Frames[FrameIndex % QuickStatsFeed::MaxFrames];
+
+	const uint64 Sequence = Frame.Sequence.load(std::memory_order_relaxed);
+	Frame.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Frame.SchemaSequence = Region->Schema.Sequence.load(std::memory_order_relaxed);
+	Frame.FrameNumber = FrameNumber;
+	Frame.Time = Time;
+	Frame.NumValues = FMath::Min<uint32>(Values.Num(), QuickStatsFeed::MaxStats);
+	FMemory::Memcpy(Frame.Values, Values.GetData(), Frame.NumValues * sizeof(double));
+
+	Frame.Sequence.store(Sequence + 2, std::memory_order_release);
+	Region->Header.NumFramesWritten.store(FrameIndex + 1, std::memory_order_release);
+}
+
+#endif //#if STATS
@@ -0,0 +1,37 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+
+namespace QuickStatsFeed
+{
+	struct FRegion;
+}
+
+/*
+* Publishes evaluated stats to a named shared memory region, layout is defined in QuickStatsFeedLayout.h.
+* Writing a frame is a copy of the values into a preallocated ring slot, readers don't add any cost to the game.
+*/
+class FQuickStatsSharedMemoryFeed : public IQuickStatsFeed
+{
+public:
+	FQuickStatsSharedMemoryFeed();
+	virtual ~FQuickStatsSharedMemoryFeed();
+
+	// false if the platform doesn't support named shared memory or the region couldn't be created
+	bool IsValid() const { return Region != nullptr; }
+
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+private:
+	FPlatformMemory::FSharedMemoryRegion* SharedMemoryRegion = nullptr;
+	QuickStatsFeed::FRegion* Region = nullptr;
+};
+
+#endif //#if STATS
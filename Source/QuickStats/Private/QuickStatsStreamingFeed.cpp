@@ -0,0 +1,452 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsStreamingFeed.h"
+
+#if STATS
+
+#include "QuickStatsStreamProtocol.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+// slow clients are disconnected instead of buffering indefinitely
+static constexpr int32 MaxPendingDataPerClient = 4 * 1024 * 1024;
+// frames the background thread can fall behind, several packets of the largest batch size
+static constexpr uint32 RingCapacity = 1024;
+
+template<typename T>
+static void AppendPOD(TArray<uint8>& Data, const T& Value)
+{
+	Data.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+}
+
+static void AppendVarint(TArray<uint8>& Data, uint64 Value)
+{
+	uint8 Buffer[QuickStatsStream::MaxVarintSize];
+	const uint32 Size = QuickStatsStream::WriteVarint(Buffer, Value);
+	Data.Append(Buffer, Size);
+}
+
+static void AppendShortString(TArray<uint8>& Data, const FString& String)
+{
+	const FTCHARToUTF8 UTF8String(*String);
+	const uint8 Length = (uint8)FMath::Min(UTF8String.Length(), 255);
+	Data.Add(Length);
+	Data.Append(reinterpret_cast<const uint8*>(UTF8String.Get()), Length);
+}
+
+// payload size is patched once the message is complete
+static int32 BeginMessage(TArray<uint8>& Data, QuickStatsStream::EMessageType MessageType)
+{
+	const int32 MessageOffset = Data.Num();
+	AppendPOD(Data, uint32(0));
+	Data.Add((uint8)MessageType);
+	return MessageOffset;
+}
+
+static void EndMessage(TArray<uint8>& Data, int32 MessageOffset)
+{
+	const uint32 PayloadSize = Data.Num() - MessageOffset - QuickStatsStream::MessageHeaderSize;
+	FMemory::Memcpy(Data.GetData() + MessageOffset, &PayloadSize, sizeof(PayloadSize));
+}
+
+FQuickStatsStreamingFeed::FQuickStatsStreamingFeed(int32 InPort, bool bListenOnAllInterfaces, int32 InFramesPerPacket)
+	: FramesPerPacket(FMath::Max(InFramesPerPacket, 1))
+{
+	Ring.SetNum(RingCapacity);
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!SocketSubsystem)
+	{
+		return;
+	}
+
+	TSharedRef<FInternetAddr> ListenAddress = SocketSubsystem->CreateInternetAddr();
+	if (bListenOnAllInterfaces)
+	{
+		ListenAddress->SetAnyAddress();
+	}
+	else
+	{
+		ListenAddress->SetLoopbackAddress();
+	}
+	ListenAddress->SetPort(InPort);
+
+	ListenSocket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("QuickStatsStream"), false);
+	if (!ListenSocket || !ListenSocket->SetReuseAddr() || !ListenSocket->SetNonBlocking() || !ListenSocket->Bind(*ListenAddress) || !ListenSocket->Listen(8))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to listen on %s, stats won't be streamed."), *ListenAddress->ToString(true));
+		DestroySocket(ListenSocket);
+		return;
+	}
+	Port = ListenSocket->GetPortNo();
+	ListenAddress->SetPort(Port);
+
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("QuickStatsStreaming"), 0, TPri_BelowNormal);
+	if (Thread)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[QuickStat] Streaming stats on %s"), *ListenAddress->ToString(true));
+	}
+	else
+	{
+		DestroySocket(ListenSocket);
+	}
+}
+
+FQuickStatsStreamingFeed::~FQuickStatsStreamingFeed()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	for (FClient& Client : Clients)
+	{
+		DestroySocket(Client.Socket);
+	}
+	Clients.Reset();
+	DestroySocket(ListenSocket);
+
+	if (WorkEvent)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+	}
+}
+
+void FQuickStatsStreamingFeed::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	// schema is always queued, clients connecting later need it
+	FQueuedSchema QueuedSchema;
+	QueuedSchema.Serial = ++QueuedSchemaSerial;
+	QueuedSchema.Stats = Stats;
+	SchemaQueue.Enqueue(MoveTemp(QueuedSchema));
+	WorkEvent->Trigger();
+}
+
+void FQuickStatsStreamingFeed::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (!Thread || !IsActive())
+	{
+		return;
+	}
+
+	const uint32 Head = RingHead.load(std::memory_order_relaxed);
+	if (Head - RingTail.load(std::memory_order_acquire) >= RingCapacity)
+	{
+		WorkEvent->Trigger();
+		return;
+	}
+
+	FFrameSlot& Slot = Ring[Head % RingCapacity];
+	Slot.SchemaSerial = QueuedSchemaSerial;
+	Slot.FrameNumber = FrameNumber;
+	Slot.Time = Time;
+	Slot.Values.Reset();
+	Slot.Values.Append(Values.GetData(), Values.Num());
+	RingHead.store(Head + 1, std::memory_order_release);
+
+	// background thread wakes up once per packet
+	if (FrameNumber % FramesPerPacket == 0)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+uint32 FQuickStatsStreamingFeed::Run()
+{
+	while (!bStopping.load(std::memory_order_relaxed))
+	{
+		WorkEvent->Wait(50);
+
+		AcceptClients();
+		ProcessQueue();
+		FlushPendingData();
+		RemoveDisconnectedClients();
+	}
+	return 0;
+}
+
+void FQuickStatsStreamingFeed::Stop()
+{
+	bStopping.store(true, std::memory_order_relaxed);
+	if (WorkEvent)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FQuickStatsStreamingFeed::AcceptClients()
+{
+	bool bHasPendingConnection = false;
+	while (ListenSocket->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* ClientSocket = ListenSocket->Accept(TEXT("QuickStatsStreamClient"));
+		if (!ClientSocket)
+		{
+			break;
+		}
+		ClientSocket->SetNonBlocking();
+		ClientSocket->SetNoDelay();
+
+		// existing clients must not receive a partial batch encoded against a baseline the new client doesn't have
+		ProcessQueue();
+		FlushBatch();
+		bNeedsKeyFrame = true;
+
+		TArray<uint8> Message;
+		const int32 HelloOffset = BeginMessage(Message, QuickStatsStream::EMessageType::Hello);
+		AppendPOD(Message, QuickStatsStream::ProtocolVersion);
+		EndMessage(Message, HelloOffset);
+		WriteSchemaMessage(Message);
+
+		FClient& Client = Clients.AddDefaulted_GetRef();
+		Client.Socket = ClientSocket;
+		SendToClient(Client, Message.GetData(), Message.Num());
+
+		NumClients.store(Clients.Num(), std::memory_order_relaxed);
+	}
+}
+
+void FQuickStatsStreamingFeed::ProcessQueue()
+{
+	for (;;)
+	{
+		// schema is peeked before the ring, frames evaluated with the schemas before it are then already in the ring
+		const FQueuedSchema* NextSchema = SchemaQueue.Peek();
+		const uint32 NextSchemaSerial = NextSchema ? NextSchema->Serial : 0;
+
+		const uint32 Head = RingHead.load(std::memory_order_acquire);
+		uint32 Tail = RingTail.load(std::memory_order_relaxed);
+		if (Tail == Head)
+		{
+			if (!NextSchema)
+			{
+				return;
+			}
+			ProcessSchemas(NextSchemaSerial);
+			continue;
+		}
+
+		for (; Tail != Head; ++Tail)
+		{
+			const FFrameSlot& Slot = Ring[Tail % RingCapacity];
+			ProcessSchemas(Slot.SchemaSerial);
+
+			if (Clients.Num() > 0 && Slot.SchemaSerial == SchemaSerial && Slot.Values.Num() == Schema.Num())
+			{
+				EncodeFrame(Slot);
+				if (NumBatchedFrames >= FramesPerPacket)
+				{
+					FlushBatch();
+				}
+			}
+
+			// slot goes back to the game thread
+			RingTail.store(Tail + 1, std::memory_order_release);
+		}
+	}
+}
+
+void FQuickStatsStreamingFeed::ProcessSchemas(uint32 MaxSerial)
+{
+	FQueuedSchema* QueuedSchema = SchemaQueue.Peek();
+	while (QueuedSchema && QueuedSchema->Serial <= MaxSerial)
+	{
+		FlushBatch();
+
+		Schema = MoveTemp(QueuedSchema->Stats);
+		SchemaSerial = QueuedSchema->Serial;
+		SchemaId++;
+		bNeedsKeyFrame = true;
+
+		TArray<uint8> Message;
+		WriteSchemaMessage(Message);
+		for (FClient& Client : Clients)
+		{
+			SendToClient(Client, Message.GetData(), Message.Num());
+		}
+
+		SchemaQueue.Pop();
+		QueuedSchema = SchemaQueue.Peek();
+	}
+}
+
+void FQuickStatsStreamingFeed::EncodeFrame(const FFrameSlot& Frame)
+{
+	if (NumBatchedFrames == 0)
+	{
+		bBatchIsKeyFrame = bNeedsKeyFrame;
+	}
+
+	const uint64 TimeMicroseconds = (uint64)FMath::Max(Frame.Time * 1000000., 0.);
+	if (bNeedsKeyFrame)
+	{
+		PreviousValueBits.Reset(Schema.Num());
+		PreviousValueBits.AddZeroed(Schema.Num());
+		PreviousFrameNumber = 0;
+		PreviousTimeMicroseconds = 0;
+		bNeedsKeyFrame = false;
+	}
+
+	AppendVarint(BatchPayload, Frame.FrameNumber - PreviousFrameNumber);
+	AppendVarint(BatchPayload, TimeMicroseconds - FMath::Min(PreviousTimeMicroseconds, TimeMicroseconds));
+	PreviousFrameNumber = Frame.FrameNumber;
+	PreviousTimeMicroseconds = TimeMicroseconds;
+
+	const int32 MaskOffset = BatchPayload.AddZeroed((Schema.Num() + 7) / 8);
+	for (int32 StatIndex = 0; StatIndex < Schema.Num(); ++StatIndex)
+	{
+		uint64 ValueBits;
+		FMemory::Memcpy(&ValueBits, &Frame.Values[StatIndex], sizeof(ValueBits));
+
+		const uint64 ChangedBits = ValueBits ^ PreviousValueBits[StatIndex];
+		if (ChangedBits != 0)
+		{
+			BatchPayload[MaskOffset + StatIndex / 8] |= (1 << (StatIndex % 8));
+
+			const uint8 TrailingZeros = (uint8)FMath::CountTrailingZeros64(ChangedBits);
+			BatchPayload.Add(TrailingZeros);
+			AppendVarint(BatchPayload, ChangedBits >> TrailingZeros);
+
+			PreviousValueBits[StatIndex] = ValueBits;
+		}
+	}
+
+	NumBatchedFrames++;
+}
+
+void FQuickStatsStreamingFeed::FlushBatch()
+{
+	if (NumBatchedFrames == 0)
+	{
+		return;
+	}
+
+	TArray<uint8> Message;
+	Message.Reserve(BatchPayload.Num() + 16);
+
+	const int32 MessageOffset = BeginMessage(Message, QuickStatsStream::EMessageType::Values);
+	AppendPOD(Message, SchemaId);
+	Message.Add(bBatchIsKeyFrame ? QuickStatsStream::KeyFrame : 0);
+	AppendPOD(Message, (uint16)NumBatchedFrames);
+	Message.Append(BatchPayload);
+	EndMessage(Message, MessageOffset);
+
+	for (FClient& Client : Clients)
+	{
+		SendToClient(Client, Message.GetData(), Message.Num());
+	}
+
+	BatchPayload.Reset();
+	NumBatchedFrames = 0;
+}
+
+void FQuickStatsStreamingFeed::WriteSchemaMessage(TArray<uint8>& OutMessage) const
+{
+	const int32 MessageOffset = BeginMessage(OutMessage, QuickStatsStream::EMessageType::Schema);
+	AppendPOD(OutMessage, SchemaId);
+	AppendPOD(OutMessage, (uint16)Schema.Num());
+	for (const FQuickStatsFeedStat& Stat : Schema)
+	{
+		AppendPOD(OutMessage, Stat.Budget);
+		AppendShortString(OutMessage, Stat.PresetName.ToString());
+		AppendShortString(OutMessage, Stat.StatDescription);
+	}
+	EndMessage(OutMessage, MessageOffset);
+}
+
+void FQuickStatsStreamingFeed::SendToClient(FClient& Client, const uint8* Data, int32 Size)
+{
+	if (!Client.Socket)
+	{
+		return;
+	}
+
+	// keep the stream ordered, new data goes behind anything still pending
+	if (Client.PendingData.Num() == 0)
+	{
+		int32 BytesSent = 0;
+		if (!Client.Socket->Send(Data, Size, BytesSent))
+		{
+			const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+			if (Error != SE_EWOULDBLOCK && Error != SE_NO_ERROR)
+			{
+				DestroySocket(Client.Socket);
+				return;
+			}
+			BytesSent = 0;
+		}
+		Data += BytesSent;
+		Size -= BytesSent;
+	}
+
+	if (Size > 0)
+	{
+		if (Client.PendingData.Num() + Size > MaxPendingDataPerClient)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Stream client can't keep up, disconnecting."));
+			DestroySocket(Client.Socket);
+			return;
+		}
+		Client.PendingData.Append(Data, Size);
+	}
+}
+
+void FQuickStatsStreamingFeed::FlushPendingData()
+{
+	for (FClient& Client : Clients)
+	{
+		if (Client.Socket && Client.PendingData.Num() > 0)
+		{
+			TArray<uint8> PendingData = MoveTemp(Client.PendingData);
+			Client.PendingData.Reset();
+			SendToClient(Client, PendingData.GetData(), PendingData.Num());
+		}
+	}
+}
+
+void FQuickStatsStreamingFeed::RemoveDisconnectedClients()
+{
+	for (FClient& Client : Clients)
+	{
+		// peers don't send anything, so a readable socket means it was closed
+		if (Client.Socket && Client.Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::Zero()))
+		{
+			uint8 Buffer[256];
+			int32 BytesRead = 0;
+			if (!Client.Socket->Recv(Buffer, sizeof(Buffer), BytesRead) || BytesRead == 0)
+			{
+				DestroySocket(Client.Socket);
+			}
+		}
+	}
+
+	const int32 NumRemoved = Clients.RemoveAll([](const FClient& Client) { return Client.Socket == nullptr; });
+	if (NumRemoved > 0)
+	{
+		NumClients.store(Clients.Num(), std::memory_order_relaxed);
+	}
+}
+
+void FQuickStatsStreamingFeed::DestroySocket(FSocket*& Socket)
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+#endif //#if STATS
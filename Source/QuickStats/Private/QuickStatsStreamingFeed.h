@@ -0,0 +1,114 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "QuickStatsFeed.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+class FSocket;
+class FRunnableThread;
+class FEvent;
+
+/*
+* Streams evaluated stats to remote viewers over TCP, wire format is defined in QuickStatsStreamProtocol.h.
+* Game thread only copies the values into a preallocated ring, encoding, batching and sending happen on a background thread.
+*/
+class FQuickStatsStreamingFeed : public IQuickStatsFeed, public FRunnable
+{
+public:
+	FQuickStatsStreamingFeed(int32 InPort, bool bListenOnAllInterfaces, int32 InFramesPerPacket);
+	virtual ~FQuickStatsStreamingFeed();
+
+	// false if the listen socket couldn't be created
+	bool IsValid() const { return Thread != nullptr; }
+	// port the server listens on, differs from the requested one if that was 0
+	int32 GetPort() const { return Port; }
+
+	// IQuickStatsFeed
+	virtual bool IsActive() const override { return NumClients.load(std::memory_order_relaxed) > 0; }
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FQueuedSchema
+	{
+		uint32 Serial = 0;
+		TArray<FQuickStatsFeedStat> Stats;
+	};
+
+	// values keep their allocation, slots only allocate until they fit the largest schema
+	struct FFrameSlot
+	{
+		uint32 SchemaSerial = 0;
+		uint64 FrameNumber = 0;
+		double Time = 0.;
+		TArray<double> Values;
+	};
+
+	struct FClient
+	{
+		FSocket* Socket = nullptr;
+		// data the socket couldn't accept yet
+		TArray<uint8> PendingData;
+	};
+
+	// background thread
+	void AcceptClients();
+	void ProcessQueue();
+	// applies queued schemas up to the one the next frame was evaluated with
+	void ProcessSchemas(uint32 MaxSerial);
+	void EncodeFrame(const FFrameSlot& Frame);
+	void FlushBatch();
+	void WriteSchemaMessage(TArray<uint8>& OutMessage) const;
+	void SendToClient(FClient& Client, const uint8* Data, int32 Size);
+	void FlushPendingData();
+	void RemoveDisconnectedClients();
+	void DestroySocket(FSocket*& Socket);
+
+private:
+	FSocket* ListenSocket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	FEvent* WorkEvent = nullptr;
+	int32 Port = 0;
+	std::atomic<bool> bStopping{ false };
+	// frames are only queued if somebody is listening
+	std::atomic<int32> NumClients{ 0 };
+
+	// schema changes are rare, frames go through the ring. Frames are dropped while the ring is full,
+	// clients see a gap in frame numbers.
+	TQueue<FQueuedSchema, EQueueMode::Spsc> SchemaQueue;
+	TArray<FFrameSlot> Ring;
+	std::atomic<uint32> RingHead{ 0 };
+	std::atomic<uint32> RingTail{ 0 };
+
+	// owned by the game thread
+	uint32 QueuedSchemaSerial = 0;
+
+	// owned by the background thread
+	TArray<FClient> Clients;
+	TArray<FQuickStatsFeedStat> Schema;
+	uint32 SchemaSerial = 0;
+	uint32 SchemaId = 0;
+	int32 FramesPerPacket = 1;
+
+	TArray<uint8> BatchPayload;
+	int32 NumBatchedFrames = 0;
+	bool bBatchIsKeyFrame = false;
+	bool bNeedsKeyFrame = true;
+
+	TArray<uint64> PreviousValueBits;
+	uint64 PreviousFrameNumber = 0;
+	uint64 PreviousTimeMicroseconds = 0;
+};
+
+#endif //#if STATS
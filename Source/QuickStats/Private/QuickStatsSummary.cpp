@@ -0,0 +1,142 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsSummary.h"
+
+FQuickStatsQuantile::FQuickStatsQuantile(double InQuantile)
+	: Quantile(InQuantile)
+{
+}
+
+void FQuickStatsQuantile::Add(double Value)
+{
+	// first five values initialize the markers
+	if (NumValues < 5)
+	{
+		Heights[NumValues++] = Value;
+		if (NumValues == 5)
+		{
+			Sort(Heights, 5);
+			for (int32 Index = 0; Index < 5; ++Index)
+			{
+				Positions[Index] = Index;
+			}
+			DesiredPositions[0] = 0.;
+			DesiredPositions[1] = 2. * Quantile;
+			DesiredPositions[2] = 4. * Quantile;
+			DesiredPositions[3] = 2. + 2. * Quantile;
+			DesiredPositions[4] = 4.;
+			DesiredIncrements[0] = 0.;
+			DesiredIncrements[1] = Quantile / 2.;
+			DesiredIncrements[2] = Quantile;
+			DesiredIncrements[3] = (1. + Quantile) / 2.;
+			DesiredIncrements[4] = 1.;
+		}
+		return;
+	}
+	NumValues++;
+
+	// cell containing the value, extreme markers track min and max
+	int32 Cell = 0;
+	if (Value < Heights[0])
+	{
+		Heights[0] = Value;
+	}
+	else if (Value >= Heights[4])
+	{
+		Heights[4] = Value;
+		Cell = 3;
+	}
+	else
+	{
+		while (Cell < 3 && Value >= Heights[Cell + 1])
+		{
+			Cell++;
+		}
+	}
+
+	for (int32 Index = Cell + 1; Index < 5; ++Index)
+	{
+		Positions[Index] += 1.;
+	}
+	for (int32 Index = 0; Index < 5; ++Index)
+	{
+		DesiredPositions[Index] += DesiredIncrements[Index];
+	}
+
+	// move middle markers towards their desired positions
+	for (int32 Index = 1; Index < 4; ++Index)
+	{
+		const double Delta = DesiredPositions[Index] - Positions[Index];
+		if ((Delta >= 1. && Positions[Index + 1] - Positions[Index] > 1.) || (Delta <= -1. && Positions[Index - 1] - Positions[Index] < -1.))
+		{
+			const double Sign = (Delta > 0.) ? 1. : -1.;
+
+			// piecewise parabolic prediction, linear if it would break ordering of markers
+			const double Parabolic = Heights[Index] + Sign / (Positions[Index + 1] - Positions[Index - 1])
+				* ((Positions[Index] - Positions[Index - 1] + Sign) * (Heights[Index + 1] - Heights[Index]) / (Positions[Index + 1] - Positions[Index])
+				+ (Positions[Index + 1] - Positions[Index] - Sign) * (Heights[Index] - Heights[Index - 1]) / (Positions[Index] - Positions[Index - 1]));
+
+			if (Heights[Index - 1] < Parabolic && Parabolic < Heights[Index + 1])
+			{
+				Heights[Index] = Parabolic;
+			}
+			else
+			{
+				const int32 Neighbour = Index + static_cast<int32>(Sign);
+				Heights[Index] += Sign * (Heights[Neighbour] - Heights[Index]) / (Positions[Neighbour] - Positions[Index]);
+			}
+			Positions[Index] += Sign;
+		}
+	}
+}
+
+double FQuickStatsQuantile::Get() const
+{
+	if (NumValues == 0)
+	{
+		return 0.;
+	}
+
+	if (NumValues < 5)
+	{
+		// exact quantile of the few values we have
+		double SortedValues[5];
+		FMemory::Memcpy(SortedValues, Heights, sizeof(double) * NumValues);
+		Sort(SortedValues, static_cast<int32>(NumValues));
+		const int32 Index = FMath::Clamp(FMath::RoundToInt(Quantile * (NumValues - 1)), 0, static_cast<int32>(NumValues) - 1);
+		return SortedValues[Index];
+	}
+
+	return Heights[2];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+FQuickStatsSummary::FQuickStatsSummary()
+	: P50(0.5)
+	, P95(0.95)
+	, P99(0.99)
+{
+}
+
+void FQuickStatsSummary::Add(double Value, double Budget)
+{
+	if (FMath::IsNaN(Value))
+	{
+		return;
+	}
+
+	Min = (NumFrames > 0) ? FMath::Min(Min, Value) : Value;
+	Max = (NumFrames > 0) ? FMath::Max(Max, Value) : Value;
+	Sum += Value;
+	NumFrames++;
+
+	if (Budget > 0. && Value > Budget)
+	{
+		NumOverBudgetFrames++;
+	}
+
+	P50.Add(Value);
+	P95.Add(Value);
+	P99.Add(Value);
+}
@@ -0,0 +1,49 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Streaming quantile estimate using the P-square algorithm (Jain & Chlamtac), five markers regardless of number of samples.
+*/
+struct FQuickStatsQuantile
+{
+	explicit FQuickStatsQuantile(double InQuantile);
+
+	void Add(double Value);
+	double Get() const;
+
+private:
+	double Quantile = 0.5;
+	int64 NumValues = 0;
+
+	// marker heights, actual and desired marker positions
+	double Heights[5] = {};
+	double Positions[5] = {};
+	double DesiredPositions[5] = {};
+	double DesiredIncrements[5] = {};
+};
+
+/*
+* Constant memory summary of a stat over many frames.
+*/
+struct FQuickStatsSummary
+{
+	FQuickStatsSummary();
+
+	// NaN values (stat couldn't be evaluated) are ignored, budget <= 0 means no budget
+	void Add(double Value, double Budget);
+
+	double GetMean() const { return (NumFrames > 0) ? Sum / NumFrames : 0.; }
+
+	int64 NumFrames = 0;
+	int64 NumOverBudgetFrames = 0;
+	double Min = 0.;
+	double Max = 0.;
+	double Sum = 0.;
+
+	FQuickStatsQuantile P50;
+	FQuickStatsQuantile P95;
+	FQuickStatsQuantile P99;
+};
@@ -0,0 +1,72 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTraceFeed.h"
+
+#if QUICKSTATS_TRACE_ENABLED
+
+#include "Trace/Trace.h"
+
+UE_TRACE_CHANNEL(QuickStatsChannel);
+
+bool FQuickStatsTraceFeed::IsActive() const
+{
+	return UE_TRACE_CHANNELEXPR_IS_ENABLED(QuickStatsChannel);
+}
+
+void FQuickStatsTraceFeed::OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats)
+{
+	CounterNames.Reset(Stats.Num());
+	for (const FQuickStatsFeedStat& Stat : Stats)
+	{
+		CounterNames.Add(FString::Printf(TEXT("QuickStats/%s/%s"), *Stat.PresetName.ToString(), *Stat.StatDescription));
+	}
+
+	CounterIds.Reset(Stats.Num());
+	CounterIds.AddZeroed(Stats.Num());
+
+	// registered on first evaluation, channel might not be enabled yet
+	bCountersRegistered = false;
+}
+
+void FQuickStatsTraceFeed::OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values)
+{
+	if (!bCountersRegistered)
+	{
+		RegisterCounters();
+	}
+
+	const int32 NumValues = FMath::Min(Values.Num(), CounterIds.Num());
+	for (int32 ValueIndex = 0; ValueIndex < NumValues; ++ValueIndex)
+	{
+		const double Value = Values[ValueIndex];
+		if (CounterIds[ValueIndex] != 0 && !FMath::IsNaN(Value))
+		{
+			FCountersTrace::OutputSetValue(CounterIds[ValueIndex], Value);
+		}
+	}
+}
+
+void FQuickStatsTraceFeed::RegisterCounters()
+{
+	for (int32 CounterIndex = 0; CounterIndex < CounterNames.Num(); ++CounterIndex)
+	{
+		const FString& CounterName = CounterNames[CounterIndex];
+
+		uint16* CounterId = RegisteredCounters.Find(CounterName);
+		if (!CounterId)
+		{
+			// zero means counters channel is disabled, try again next frame
+			const uint16 NewCounterId = FCountersTrace::OutputInitCounter(*CounterName, TraceCounterType_Float, TraceCounterDisplayHint_None);
+			if (NewCounterId == 0)
+			{
+				return;
+			}
+			CounterId = &RegisteredCounters.Add(CounterName, NewCounterId);
+		}
+		CounterIds[CounterIndex] = *CounterId;
+	}
+
+	bCountersRegistered = true;
+}
+
+#endif //#if QUICKSTATS_TRACE_ENABLED
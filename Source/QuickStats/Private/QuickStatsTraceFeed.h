@@ -0,0 +1,38 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+#define QUICKSTATS_TRACE_ENABLED (STATS && COUNTERSTRACE_ENABLED)
+
+#if QUICKSTATS_TRACE_ENABLED
+
+#include "QuickStatsFeed.h"
+
+/*
+* Emits evaluated stats as Unreal Insights counters ("QuickStats/Preset/Stat"), enabled with -trace=QuickStats,Counters.
+* Counters are registered once per stat name, per frame cost is one counter event per stat while the channel is enabled.
+*/
+class FQuickStatsTraceFeed : public IQuickStatsFeed
+{
+public:
+	virtual bool IsActive() const override;
+	virtual void OnSchemaChanged(TArrayView<const FQuickStatsFeedStat> Stats) override;
+	virtual void OnStatsEvaluated(uint64 FrameNumber, double Time, double FrameDuration, TArrayView<const double> Values) override;
+
+private:
+	void RegisterCounters();
+
+private:
+	TArray<FString> CounterNames;
+	// counter ids of the current schema, 0 if not registered yet
+	TArray<uint16> CounterIds;
+	bool bCountersRegistered = false;
+
+	// trace can't unregister counters, re-enabled presets reuse their counters
+	TMap<FString, uint16> RegisteredCounters;
+};
+
+#endif //#if QUICKSTATS_TRACE_ENABLED
@@ -0,0 +1,336 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "SQuickStatsOverlay.h"
+
+#if STATS
+
+#include "Engine/Engine.h"
+#include "Engine/Font.h"
+#include "Styling/CoreStyle.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SInvalidationPanel.h"
+#include "Widgets/SLeafWidget.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SGridPanel.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Text/STextBlock.h"
+
+// stacked bar of a preset, same look as the bar drawn on canvas
+class SQuickStatsBar : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SQuickStatsBar) {}
+		SLATE_ARGUMENT(float, MinWidth)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs)
+	{
+		MinWidth = InArgs._MinWidth;
+	}
+
+	void SetBar(const TArray<FQuickStatsBarSegment>& InSegments, float InBudgetFraction)
+	{
+		if (Segments != InSegments || BudgetFraction != InBudgetFraction)
+		{
+			Segments = InSegments;
+			BudgetFraction = InBudgetFraction;
+			Invalidate(EInvalidateWidgetReason::Paint);
+		}
+	}
+
+	virtual FVector2D ComputeDesiredSize(float) const override
+	{
+		// height is filled from the value text of the row
+		return FVector2D(MinWidth, 1.f);
+	}
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override
+	{
+		const FSlateBrush* Brush = FCoreStyle::Get().GetBrush("WhiteBrush");
+		const FVector2D Size = AllottedGeometry.GetLocalSize();
+		const float BarHeight = Size.Y * 0.7f;
+		const float BarY = (Size.Y - BarHeight) * 0.5f;
+
+		auto AddBox = [&](int32 Layer, const FVector2D& Min, const FVector2D& Max, const FLinearColor& Color)
+		{
+			FSlateDrawElement::MakeBox(OutDrawElements, Layer, AllottedGeometry.ToPaintGeometry(Max - Min, FSlateLayoutTransform(Min)), Brush, ESlateDrawEffect::None, Color);
+		};
+
+		AddBox(LayerId, FVector2D(0.f, BarY), FVector2D(Size.X, BarY + BarHeight), FLinearColor(0.1f, 0.1f, 0.1f, 0.8f));
+
+		float SegmentX = 0.f;
+		for (const FQuickStatsBarSegment& Segment : Segments)
+		{
+			const float SegmentWidth = Segment.Fraction * Size.X;
+			const FVector2D SegmentMin(SegmentX, BarY);
+			const FVector2D SegmentMax(SegmentX + SegmentWidth, BarY + BarHeight);
+			AddBox(LayerId + 1, SegmentMin, SegmentMax, FLinearColor(Segment.Color));
+
+			// stats over their own budget are outlined
+			if (Segment.bIsOverBudget)
+			{
+				const float Border = FMath::Min(2.f, SegmentWidth * 0.5f);
+				AddBox(LayerId + 2, SegmentMin, FVector2D(SegmentMax.X, SegmentMin.Y + 2.f), FLinearColor::Red);
+				AddBox(LayerId + 2, FVector2D(SegmentMin.X, SegmentMax.Y - 2.f), SegmentMax, FLinearColor::Red);
+				AddBox(LayerId + 2, SegmentMin, FVector2D(SegmentMin.X + Border, SegmentMax.Y), FLinearColor::Red);
+				AddBox(LayerId + 2, FVector2D(SegmentMax.X - Border, SegmentMin.Y), SegmentMax, FLinearColor::Red);
+			}
+			SegmentX += SegmentWidth;
+		}
+
+		// budget marker
+		if (BudgetFraction >= 0.f)
+		{
+			const float MarkerX = BudgetFraction * Size.X;
+			AddBox(LayerId + 2, FVector2D(MarkerX - 1.f, 0.f), FVector2D(MarkerX + 1.f, Size.Y), FLinearColor::White);
+		}
+		return LayerId + 2;
+	}
+
+private:
+	float MinWidth = 0.f;
+	TArray<FQuickStatsBarSegment> Segments;
+	float BudgetFraction = -1.f;
+};
+
+void SQuickStatsOverlay::Construct(const FArguments& InArgs)
+{
+	const UFont* LargeFont = GEngine->GetLargeFont();
+	Font = FSlateFontInfo(LargeFont, LargeFont->LegacyFontSize);
+
+	SetVisibility(EVisibility::HitTestInvisible);
+
+	ChildSlot
+	.HAlign(HAlign_Left)
+	.VAlign(VAlign_Top)
+	[
+		SAssignNew(RootBox, SBox)
+		.Padding(FMargin(Position.X, Position.Y, 0.f, 0.f))
+		[
+			SNew(SInvalidationPanel)
+			[
+				SAssignNew(BackgroundBorder, SBorder)
+				.BorderImage(FCoreStyle::Get().GetBrush("WhiteBrush"))
+				.BorderBackgroundColor(BackgroundColor)
+				.Padding(8.f)
+				[
+					SAssignNew(RowsGrid, SGridPanel)
+				]
+			]
+		]
+	];
+}
+
+void SQuickStatsOverlay::SetLayout(const FVector2D& InPosition, int32 InColumnSpacing, int32 InPresetScopePadding, const FLinearColor& InBackgroundColor)
+{
+	if (Position != InPosition)
+	{
+		Position = InPosition;
+		RootBox->SetPadding(FMargin(Position.X, Position.Y, 0.f, 0.f));
+	}
+
+	if (BackgroundColor != InBackgroundColor)
+	{
+		BackgroundColor = InBackgroundColor;
+		BackgroundBorder->SetBorderBackgroundColor(BackgroundColor);
+	}
+
+	if (ColumnSpacing != InColumnSpacing || PresetScopePadding != InPresetScopePadding)
+	{
+		ColumnSpacing = InColumnSpacing;
+		PresetScopePadding = InPresetScopePadding;
+
+		TArray<FQuickStatsRow> Rows;
+		TArray<FIntPoint> Cells;
+		Rows.Reserve(RowWidgets.Num());
+		Cells.Reserve(RowWidgets.Num());
+		for (const FRowWidgets& Widgets : RowWidgets)
+		{
+			Rows.Add(Widgets.Row);
+			Cells.Add(Widgets.Cell);
+		}
+		RebuildRows(Rows, Cells);
+	}
+}
+
+void SQuickStatsOverlay::SetRows(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells)
+{
+	if (!HasSameRowStructure(Rows, Cells))
+	{
+		RebuildRows(Rows, Cells);
+		return;
+	}
+
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const FQuickStatsRow& NewRow = Rows[RowIndex];
+		FRowWidgets& Widgets = RowWidgets[RowIndex];
+
+		// only touch widgets that changed, anything else stays cached by the invalidation panel
+		if (Widgets.Row.ValueText != NewRow.ValueText)
+		{
+			Widgets.Row.ValueText = NewRow.ValueText;
+			Widgets.ValueWidget->SetText(FText::FromString(NewRow.ValueText));
+		}
+
+		if (Widgets.Row.Color != NewRow.Color)
+		{
+			Widgets.Row.Color = NewRow.Color;
+			Widgets.TextWidget->SetColorAndOpacity(FSlateColor(FLinearColor(NewRow.Color)));
+			Widgets.ValueWidget->SetColorAndOpacity(FSlateColor(FLinearColor(NewRow.Color)));
+		}
+
+		if (Widgets.BarWidget.IsValid() && (Widgets.Row.BarSegments != NewRow.BarSegments || Widgets.Row.BarBudgetFraction != NewRow.BarBudgetFraction))
+		{
+			Widgets.Row.BarSegments = NewRow.BarSegments;
+			Widgets.Row.BarBudgetFraction = NewRow.BarBudgetFraction;
+			Widgets.BarWidget->SetBar(NewRow.BarSegments, NewRow.BarBudgetFraction);
+		}
+	}
+}
+
+bool SQuickStatsOverlay::HasSameRowStructure(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells) const
+{
+	if (Rows.Num() != RowWidgets.Num() || Cells.Num() != RowWidgets.Num())
+	{
+		return false;
+	}
+
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const FRowWidgets& Widgets = RowWidgets[RowIndex];
+		const FQuickStatsRow& OldRow = Widgets.Row;
+		const FQuickStatsRow& NewRow = Rows[RowIndex];
+		if (OldRow.bIsPresetName != NewRow.bIsPresetName || OldRow.bIsBar != NewRow.bIsBar || OldRow.Text != NewRow.Text
+			|| OldRow.SegmentColor != NewRow.SegmentColor || Widgets.Cell != Cells[RowIndex])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void SQuickStatsOverlay::RebuildRows(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells)
+{
+	RowsGrid->ClearChildren();
+	RowWidgets.Reset(Rows.Num());
+
+	// every column of the page uses two grid columns (name, value), rows spanning all columns go below the rest
+	int32 NumColumns = 1;
+	int32 NumRows = 0;
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (Cell.X != INDEX_NONE)
+		{
+			NumColumns = FMath::Max(NumColumns, Cell.X + 1);
+			NumRows = FMath::Max(NumRows, Cell.Y + 1);
+		}
+	}
+
+	const float CellPadding = 8.f;
+	const float SwatchSize = FMath::Max(4.f, Font.Size * 0.8f);
+	const float BarMinWidth = FMath::Max(16.f, ColumnSpacing - CellPadding);
+
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		const FQuickStatsRow& Row = Rows[RowIndex];
+		const FIntPoint Cell = Cells.IsValidIndex(RowIndex) ? Cells[RowIndex] : FIntPoint(0, RowIndex);
+
+		FRowWidgets& Widgets = RowWidgets.AddDefaulted_GetRef();
+		Widgets.Row = Row;
+		Widgets.Cell = Cell;
+
+		const FSlateColor RowColor = FSlateColor(FLinearColor(Row.Color));
+
+		SAssignNew(Widgets.TextWidget, STextBlock)
+		.Font(Font)
+		.Text(FText::FromString(Row.Text))
+		.ColorAndOpacity(RowColor)
+		.ShadowOffset(FVector2D(1.f, 1.f))
+		.ShadowColorAndOpacity(FLinearColor::Black);
+
+		SAssignNew(Widgets.ValueWidget, STextBlock)
+		.Font(Font)
+		.Text(FText::FromString(Row.ValueText))
+		.ColorAndOpacity(RowColor)
+		.ShadowOffset(FVector2D(1.f, 1.f))
+		.ShadowColorAndOpacity(FLinearColor::Black);
+
+		if (Cell.X == INDEX_NONE)
+		{
+			RowsGrid->AddSlot(0, NumRows++)
+			.ColumnSpan(NumColumns * 2)
+			[
+				Widgets.TextWidget.ToSharedRef()
+			];
+			continue;
+		}
+
+		const int32 NameColumn = Cell.X * 2;
+		if (Row.bIsPresetName)
+		{
+			RowsGrid->AddSlot(NameColumn, Cell.Y)
+			.ColumnSpan(2)
+			[
+				Widgets.TextWidget.ToSharedRef()
+			];
+			continue;
+		}
+
+		TSharedRef<SWidget> NameWidget = Widgets.TextWidget.ToSharedRef();
+		if (Row.bIsBar)
+		{
+			SAssignNew(Widgets.BarWidget, SQuickStatsBar)
+			.MinWidth(BarMinWidth);
+			Widgets.BarWidget->SetBar(Row.BarSegments, Row.BarBudgetFraction);
+			NameWidget = Widgets.BarWidget.ToSharedRef();
+		}
+		else if (Row.SegmentColor.A > 0)
+		{
+			// swatch links the stat to its segment in the preset's stacked bar
+			NameWidget = SNew(SHorizontalBox)
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(FMargin(0.f, 0.f, 4.f, 0.f))
+			[
+				SNew(SBox)
+				.WidthOverride(SwatchSize)
+				.HeightOverride(SwatchSize)
+				[
+					SNew(SImage)
+					.Image(FCoreStyle::Get().GetBrush("WhiteBrush"))
+					.ColorAndOpacity(FSlateColor(FLinearColor(Row.SegmentColor)))
+				]
+			]
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			[
+				Widgets.TextWidget.ToSharedRef()
+			];
+		}
+
+		// names longer than the column spacing widen the column instead of overlapping the values
+		RowsGrid->AddSlot(NameColumn, Cell.Y)
+		.Padding(FMargin(PresetScopePadding, 0.f, 0.f, 0.f))
+		.VAlign(VAlign_Fill)
+		[
+			SNew(SBox)
+			.MinDesiredWidth(ColumnSpacing)
+			.Padding(FMargin(0.f, 0.f, CellPadding, 0.f))
+			[
+				NameWidget
+			]
+		];
+
+		RowsGrid->AddSlot(NameColumn + 1, Cell.Y)
+		.Padding(FMargin(0.f, 0.f, (Cell.X + 1 < NumColumns) ? CellPadding * 2.f : 0.f, 0.f))
+		[
+			Widgets.ValueWidget.ToSharedRef()
+		];
+	}
+}
+
+#endif //#if STATS
@@ -0,0 +1,65 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if STATS
+
+#include "Widgets/SCompoundWidget.h"
+#include "QuickStatsRenderer.h"
+
+class SBox;
+class SBorder;
+class STextBlock;
+class SGridPanel;
+class SQuickStatsBar;
+
+/*
+* Retained mode alternative to drawing stats using FCanvas.
+* Content is cached by an invalidation panel, so the widget is only repainted when a displayed value or color changes.
+* Rows are placed in a grid, so stat names of any length keep the values of a column aligned.
+*/
+class SQuickStatsOverlay : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SQuickStatsOverlay) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// Position is in slate units, widgets are only invalidated if the layout changed.
+	void SetLayout(const FVector2D& InPosition, int32 InColumnSpacing, int32 InPresetScopePadding, const FLinearColor& InBackgroundColor);
+
+	// Cells place the rows, X is the column and Y the row within that column. Rows with X of INDEX_NONE span all the columns
+	// below them (page footer, messages). Rows are only rebuilt if their structure changed, otherwise just the modified
+	// text, colors and bars are updated.
+	void SetRows(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells);
+
+private:
+	struct FRowWidgets
+	{
+		FQuickStatsRow Row;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		TSharedPtr<STextBlock> TextWidget;
+		TSharedPtr<STextBlock> ValueWidget;
+		TSharedPtr<SQuickStatsBar> BarWidget;
+	};
+
+	bool HasSameRowStructure(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells) const;
+	void RebuildRows(const TArray<FQuickStatsRow>& Rows, const TArray<FIntPoint>& Cells);
+
+private:
+	TSharedPtr<SBox> RootBox;
+	TSharedPtr<SBorder> BackgroundBorder;
+	TSharedPtr<SGridPanel> RowsGrid;
+	TArray<FRowWidgets> RowWidgets;
+
+	FSlateFontInfo Font;
+	FVector2D Position = FVector2D::ZeroVector;
+	int32 ColumnSpacing = 0;
+	int32 PresetScopePadding = 0;
+	FLinearColor BackgroundColor = FLinearColor::Transparent;
+};
+
+#endif //#if STATS
@@ -0,0 +1,67 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "QuickStatsAnomalyDetector.h"
+#include "Math/RandomStream.h"
+
+// number of values flagged as Anomaly
+static int32 AddValues(FQuickStatsAnomalyDetector& Detector, FRandomStream& Random, int32 NumValues, double Mean, EQuickStatsAnomaly Anomaly)
+{
+	int32 NumAnomalies = 0;
+	for (int32 ValueIndex = 0; ValueIndex < NumValues; ++ValueIndex)
+	{
+		if (Detector.Add(Mean + Random.GetFraction() - 0.5) == Anomaly)
+		{
+			NumAnomalies++;
+		}
+	}
+	return NumAnomalies;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuickStatsAnomalyDetectorTest, "QuickStats.Anomaly.Detector", QUICKSTATS_TEST_FLAGS)
+
+bool FQuickStatsAnomalyDetectorTest::RunTest(const FString& Parameters)
+{
+	// default settings
+	const int32 WindowSize = 120;
+	const double ZScoreThreshold = 5.;
+	const double ChangePointThreshold = 8.;
+
+	FRandomStream Random(42);
+	FQuickStatsAnomalyDetector Detector(WindowSize, ZScoreThreshold, ChangePointThreshold);
+
+	// noise of a stable stat is not flagged, values during warmup never are
+	TestEqual(TEXT("Warmup isn't flagged"), AddValues(Detector, Random, WindowSize, 16., EQuickStatsAnomaly::None), WindowSize);
+	TestEqual(TEXT("Noise has no spikes"), AddValues(Detector, Random, 1000, 16., EQuickStatsAnomaly::Spike), 0);
+	TestEqual(TEXT("Noise has no level shifts"), AddValues(Detector, Random, 1000, 16., EQuickStatsAnomaly::LevelShift), 0);
+	TestEqual(TEXT("Mean follows the values"), Detector.GetMean(), 16., 0.1);
+
+	TestEqual(TEXT("Single spike"), static_cast<int32>(Detector.Add(40.)), static_cast<int32>(EQuickStatsAnomaly::Spike));
+	TestTrue(TEXT("Spike has a high score"), Detector.GetScore() > ZScoreThreshold);
+	TestEqual(TEXT("Invalid values are ignored"), static_cast<int32>(Detector.Add(std::numeric_limits<double>::quiet_NaN())), static_cast<int32>(EQuickStatsAnomaly::None));
+
+	// a clamped spike doesn't move the mean enough to flag the values after it
+	TestEqual(TEXT("No spikes after a spike"), AddValues(Detector, Random, 200, 16., EQuickStatsAnomaly::Spike), 0);
+	TestEqual(TEXT("No level shifts after a spike"), AddValues(Detector, Random, 200, 16., EQuickStatsAnomaly::LevelShift), 0);
+
+	// shift too small for a spike is reported once as a level shift, then the new level is accepted
+	TestEqual(TEXT("Shift is reported once"), AddValues(Detector, Random, 60, 17., EQuickStatsAnomaly::LevelShift), 1);
+	TestEqual(TEXT("Shift isn't a spike"), AddValues(Detector, Random, 200, 17., EQuickStatsAnomaly::Spike), 0);
+	TestEqual(TEXT("Mean moved to the new level"), Detector.GetMean(), 17., 0.1);
+
+	// constant counters keep a minimum deviation, so jitter of a fraction of a percent isn't flagged
+	FQuickStatsAnomalyDetector Counter(WindowSize, ZScoreThreshold, ChangePointThreshold);
+	for (int32 ValueIndex = 0; ValueIndex < 1000; ++ValueIndex)
+	{
+		Counter.Add(100.);
+	}
+	TestEqual(TEXT("Constant counter jitter"), static_cast<int32>(Counter.Add(100.5)), static_cast<int32>(EQuickStatsAnomaly::None));
+	TestEqual(TEXT("Constant counter spike"), static_cast<int32>(Counter.Add(200.)), static_cast<int32>(EQuickStatsAnomaly::Spike));
+
+	return true;
+}
+
+#endif //#if WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,90 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "QuickStatsColumnCodec.h"
+
+using namespace QuickStatsCapture;
+
+// encodes the values and checks they decode to the same bits, NaN only has to stay NaN
+static bool TestColumnRoundTrip(FAutomationTestBase& Test, const TCHAR* What, const TArray<double>& Values, EColumnEncoding ExpectedEncoding)
+{
+	FQuickStatsColumnWriter Writer;
+	for (double Value : Values)
+	{
+		Writer.Add(Value);
+	}
+
+	bool bSuccess = Test.TestEqual(FString::Printf(TEXT("%s: encoding"), What), static_cast<int32>(Writer.GetEncoding()), static_cast<int32>(ExpectedEncoding));
+	bSuccess &= Test.TestEqual(FString::Printf(TEXT("%s: number of values"), What), Writer.Num(), Values.Num());
+
+	FQuickStatsColumnReader Reader(Writer.GetEncoding(), Writer.GetData().GetData(), Writer.GetData().Num(), Writer.Num());
+	for (int32 ValueIndex = 0; ValueIndex < Values.Num(); ++ValueIndex)
+	{
+		double Value;
+		if (!Reader.Next(Value))
+		{
+			Test.AddError(FString::Printf(TEXT("%s: value %d couldn't be decoded"), What, ValueIndex));
+			return false;
+		}
+
+		const double Expected = Values[ValueIndex];
+		const bool bIsSame = FMath::IsNaN(Expected) ? FMath::IsNaN(Value) : FMemory::Memcmp(&Value, &Expected, sizeof(double)) == 0;
+		if (!bIsSame)
+		{
+			Test.AddError(FString::Printf(TEXT("%s: value %d decoded as %.17g, expected %.17g"), What, ValueIndex, Value, Expected));
+			bSuccess = false;
+		}
+	}
+
+	double Extra;
+	bSuccess &= Test.TestFalse(FString::Printf(TEXT("%s: no values after the last one"), What), Reader.Next(Extra));
+	return bSuccess;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuickStatsColumnCodecTest, "QuickStats.Capture.ColumnCodec", QUICKSTATS_TEST_FLAGS)
+
+bool FQuickStatsColumnCodecTest::RunTest(const FString& Parameters)
+{
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+	TestColumnRoundTrip(*this, TEXT("Empty"), {}, EColumnEncoding::DeltaVarint);
+	TestColumnRoundTrip(*this, TEXT("Counts"), { 0., 1., 1., 5., 1000., 999., 0. }, EColumnEncoding::DeltaVarint);
+	TestColumnRoundTrip(*this, TEXT("Negative integers"), { -1., -5., 3., -1000000., 0., -2. }, EColumnEncoding::DeltaVarint);
+	TestColumnRoundTrip(*this, TEXT("Invalid values"), { NaN, 4., NaN, NaN, -4., 4. }, EColumnEncoding::DeltaVarint);
+	TestColumnRoundTrip(*this, TEXT("Large integers"), { 9007199254740991., -9007199254740991., 0., 4294967296. }, EColumnEncoding::DeltaVarint);
+
+	// -0 and fractional values convert the column, values added before have to survive the conversion
+	TestColumnRoundTrip(*this, TEXT("Negative zero"), { 1., -2., -0., 3. }, EColumnEncoding::XorFloat);
+	TestColumnRoundTrip(*this, TEXT("Fractions"), { 16.6, 16.6, 16.7, 33.3, 0.1, -0.25, 1e300, -1e-300 }, EColumnEncoding::XorFloat);
+	TestColumnRoundTrip(*this, TEXT("Conversion"), { 10., NaN, -7., 12.5, 12.5, NaN, 8. }, EColumnEncoding::XorFloat);
+
+	// every window transition of the bit stream
+	TArray<double> Values;
+	for (int32 ValueIndex = 0; ValueIndex < 1000; ++ValueIndex)
+	{
+		Values.Add(FMath::Sin(ValueIndex * 0.37) * FMath::Pow(10., (ValueIndex % 17) - 8));
+	}
+	TestColumnRoundTrip(*this, TEXT("Mixed magnitudes"), Values, EColumnEncoding::XorFloat);
+
+	// a truncated column stops instead of reading past its data
+	FQuickStatsColumnWriter Writer;
+	for (double Value : Values)
+	{
+		Writer.Add(Value);
+	}
+	FQuickStatsColumnReader Reader(Writer.GetEncoding(), Writer.GetData().GetData(), Writer.GetData().Num() / 2, Writer.Num());
+	int32 NumDecodedValues = 0;
+	double Value;
+	while (Reader.Next(Value))
+	{
+		NumDecodedValues++;
+	}
+	TestTrue(TEXT("Truncated column stops early"), NumDecodedValues < Values.Num());
+
+	return true;
+}
+
+#endif //#if WITH_DEV_AUTOMATION_TESTS
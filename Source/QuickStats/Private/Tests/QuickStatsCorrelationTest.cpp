@@ -0,0 +1,110 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && STATS
+
+#include "QuickStatsCorrelation.h"
+#include "Math/RandomStream.h"
+
+namespace QuickStatsCorrelationTest
+{
+	enum EStat
+	{
+		// linear in frame time
+		Linear,
+		// linear in frame time with a negative slope
+		Inverse,
+		// independent of frame time
+		Noise,
+		Constant,
+		// linear in frame time with a bit of noise, invalid every other frame
+		Sparse,
+		NumStats
+	};
+
+	struct FFrameSource
+	{
+		FRandomStream Random = FRandomStream(7);
+		TArray<double> Values;
+		uint64 FrameNumber = 0;
+
+		FFrameSource() { Values.SetNumZeroed(NumStats); }
+
+		// bLinear false makes Linear independent of frame time
+		void Feed(FQuickStatsCorrelation& Correlation, int32 NumFrames, bool bLinear)
+		{
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex, ++FrameNumber)
+			{
+				const double FrameDuration = 16. + Random.GetFraction() * 4.;
+				Values[Linear] = bLinear ? FrameDuration * 2. + 1. : Random.GetFraction();
+				Values[Inverse] = 1000. - 3. * FrameDuration;
+				Values[Noise] = Random.GetFraction();
+				Values[Constant] = 5.;
+				Values[Sparse] = (FrameNumber % 2) ? std::numeric_limits<double>::quiet_NaN() : FrameDuration + Random.GetFraction() * 0.5;
+				Correlation.OnStatsEvaluated(FrameNumber, FrameNumber / 60., FrameDuration, Values);
+			}
+		}
+	};
+
+	static void TestCorrelation(FAutomationTestBase& Test, const FQuickStatsCorrelation& Correlation, const TCHAR* What, int32 StatIndex, double ExpectedCorrelation, double Tolerance, double ExpectedSlope = 0.)
+	{
+		double Value = 0.;
+		double Slope = 0.;
+		if (Test.TestTrue(FString::Printf(TEXT("%s: has correlation"), What), Correlation.GetCorrelation(StatIndex, Value, Slope)))
+		{
+			Test.TestEqual(FString::Printf(TEXT("%s: correlation"), What), Value, ExpectedCorrelation, Tolerance);
+			if (ExpectedSlope != 0.)
+			{
+				Test.TestEqual(FString::Printf(TEXT("%s: slope"), What), Slope, ExpectedSlope, 1e-6);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuickStatsCorrelationTest, "QuickStats.Feeds.Correlation", QUICKSTATS_TEST_FLAGS)
+
+bool FQuickStatsCorrelationTest::RunTest(const FString& Parameters)
+{
+	using namespace QuickStatsCorrelationTest;
+
+	TArray<FQuickStatsFeedStat> Stats;
+	for (const TCHAR* Description : { TEXT("Linear"), TEXT("Inverse"), TEXT("Noise"), TEXT("Constant"), TEXT("Sparse") })
+	{
+		FQuickStatsFeedStat& Stat = Stats.AddDefaulted_GetRef();
+		Stat.PresetName = TEXT("Test");
+		Stat.StatDescription = Description;
+	}
+
+	FQuickStatsCorrelation Correlation(100, FString());
+	Correlation.OnSchemaChanged(Stats);
+
+	double Value = 0.;
+	double Slope = 0.;
+	TestFalse(TEXT("No correlation without frames"), Correlation.GetCorrelation(Linear, Value, Slope));
+
+	// several windows, the sums are recomputed and slide over the older frames
+	FFrameSource Source;
+	Source.Feed(Correlation, 950, true);
+	TestCorrelation(*this, Correlation, TEXT("Frame time, linear"), Linear, 1., 1e-6, 0.5);
+	TestCorrelation(*this, Correlation, TEXT("Frame time, inverse"), Inverse, -1., 1e-6, -1. / 3.);
+	TestCorrelation(*this, Correlation, TEXT("Frame time, noise"), Noise, 0., 0.4);
+	TestCorrelation(*this, Correlation, TEXT("Frame time, sparse"), Sparse, 1., 0.05);
+	TestFalse(TEXT("Frame time, constant stat has no correlation"), Correlation.GetCorrelation(Constant, Value, Slope));
+
+	// once a whole window of frames is independent, older frames no longer count
+	Source.Feed(Correlation, 100, false);
+	TestCorrelation(*this, Correlation, TEXT("Frame time, window slid"), Linear, 0., 0.4);
+
+	// a stat as the target restarts the window
+	Correlation.SetTarget(TEXT("Test/Inverse"));
+	TestFalse(TEXT("Window restarts with the target"), Correlation.GetCorrelation(Linear, Value, Slope));
+	Source.Feed(Correlation, 150, true);
+	TestCorrelation(*this, Correlation, TEXT("Stat target, linear"), Linear, -1., 1e-6, -1.5);
+	TestCorrelation(*this, Correlation, TEXT("Stat target, sparse"), Sparse, -1., 0.05);
+	TestFalse(TEXT("Stat target has no correlation with itself"), Correlation.GetCorrelation(Inverse, Value, Slope));
+
+	return true;
+}
+
+#endif //#if WITH_DEV_AUTOMATION_TESTS && STATS
@@ -0,0 +1,291 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && STATS
+
+#include "QuickStatsStreamingFeed.h"
+#include "QuickStatsStreamProtocol.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "Misc/ScopeExit.h"
+
+namespace QuickStatsStreamingFeedTest
+{
+	// minimal client side of QuickStatsStreamProtocol.h
+	struct FDecoder
+	{
+		uint32 ProtocolVersion = 0;
+		uint32 SchemaId = 0;
+		TArray<FString> StatDescriptions;
+
+		TArray<uint64> FrameNumbers;
+		TArray<double> FrameTimes;
+		TArray<TArray<double>> FrameValues;
+		bool bIsValid = true;
+
+		void Decode(TArray<uint8>& Data)
+		{
+			int32 Offset = 0;
+			while (bIsValid && Data.Num() - Offset >= (int32)QuickStatsStream::MessageHeaderSize)
+			{
+				uint32 PayloadSize;
+				FMemory::Memcpy(&PayloadSize, Data.GetData() + Offset, sizeof(PayloadSize));
+				if (Data.Num() - Offset - QuickStatsStream::MessageHeaderSize < PayloadSize)
+				{
+					break;
+				}
+
+				const QuickStatsStream::EMessageType MessageType = (QuickStatsStream::EMessageType)Data[Offset + sizeof(PayloadSize)];
+				const uint8* Payload = Data.GetData() + Offset + QuickStatsStream::MessageHeaderSize;
+				bIsValid = DecodeMessage(MessageType, Payload, Payload + PayloadSize);
+				Offset += QuickStatsStream::MessageHeaderSize + PayloadSize;
+			}
+			Data.RemoveAt(0, Offset);
+		}
+
+		template<typename T>
+		static bool Read(const uint8*& Src, const uint8* End, T& OutValue)
+		{
+			if (End - Src < (int64)sizeof(T))
+			{
+				return false;
+			}
+			FMemory::Memcpy(&OutValue, Src, sizeof(T));
+			Src += sizeof(T);
+			return true;
+		}
+
+		static bool ReadString(const uint8*& Src, const uint8* End, FString& OutString)
+		{
+			uint8 Length;
+			if (!Read(Src, End, Length) || End - Src < Length)
+			{
+				return false;
+			}
+			const FUTF8ToTCHAR String(reinterpret_cast<const ANSICHAR*>(Src), Length);
+			OutString = FString(String.Length(), String.Get());
+			Src += Length;
+			return true;
+		}
+
+		bool DecodeMessage(QuickStatsStream::EMessageType MessageType, const uint8* Src, const uint8* End)
+		{
+			if (MessageType == QuickStatsStream::EMessageType::Hello)
+			{
+				return Read(Src, End, ProtocolVersion);
+			}
+
+			if (MessageType == QuickStatsStream::EMessageType::Schema)
+			{
+				uint16 NumStats;
+				if (!Read(Src, End, SchemaId) || !Read(Src, End, NumStats))
+				{
+					return false;
+				}
+
+				StatDescriptions.Reset();
+				PreviousBits.Reset();
+				PreviousBits.AddZeroed(NumStats);
+				for (int32 StatIndex = 0; StatIndex < NumStats; ++StatIndex)
+				{
+					double Budget;
+					FString PresetName, StatDescription;
+					if (!Read(Src, End, Budget) || !ReadString(Src, End, PresetName) || !ReadString(Src, End, StatDescription))
+					{
+						return false;
+					}
+					StatDescriptions.Add(StatDescription);
+				}
+				return Src == End;
+			}
+
+			uint32 ValuesSchemaId;
+			uint8 Flags;
+			uint16 NumFrames;
+			if (!Read(Src, End, ValuesSchemaId) || !Read(Src, End, Flags) || !Read(Src, End, NumFrames) || ValuesSchemaId != SchemaId)
+			{
+				return false;
+			}
+
+			if (Flags & QuickStatsStream::KeyFrame)
+			{
+				FMemory::Memzero(PreviousBits.GetData(), PreviousBits.Num() * sizeof(uint64));
+				PreviousFrameNumber = 0;
+				PreviousTimeMicroseconds = 0;
+			}
+
+			for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+			{
+				uint64 FrameDelta, TimeDelta;
+				if (!(Src = QuickStatsStream::ReadVarint(Src, End, FrameDelta)) || !(Src = QuickStatsStream::ReadVarint(Src, End, TimeDelta)))
+				{
+					return false;
+				}
+				PreviousFrameNumber += FrameDelta;
+				PreviousTimeMicroseconds += TimeDelta;
+
+				const uint8* Mask = Src;
+				Src += (PreviousBits.Num() + 7) / 8;
+				if (Src > End)
+				{
+					return false;
+				}
+
+				TArray<double>& Values = FrameValues.AddDefaulted_GetRef();
+				for (int32 StatIndex = 0; StatIndex < PreviousBits.Num(); ++StatIndex)
+				{
+					if (Mask[StatIndex / 8] & (1 << (StatIndex % 8)))
+					{
+						uint8 TrailingZeros;
+						uint64 ChangedBits;
+						if (!Read(Src, End, TrailingZeros) || TrailingZeros > 63 || !(Src = QuickStatsStream::ReadVarint(Src, End, ChangedBits)))
+						{
+							return false;
+						}
+						PreviousBits[StatIndex] ^= ChangedBits << TrailingZeros;
+					}
+
+					double Value;
+					FMemory::Memcpy(&Value, &PreviousBits[StatIndex], sizeof(Value));
+					Values.Add(Value);
+				}
+
+				FrameNumbers.Add(PreviousFrameNumber);
+				FrameTimes.Add(PreviousTimeMicroseconds / 1000000.);
+			}
+			return Src == End;
+		}
+
+	private:
+		TArray<uint64> PreviousBits;
+		uint64 PreviousFrameNumber = 0;
+		uint64 PreviousTimeMicroseconds = 0;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuickStatsStreamingFeedTest, "QuickStats.Feeds.Streaming", QUICKSTATS_TEST_FLAGS)
+
+bool FQuickStatsStreamingFeedTest::RunTest(const FString& Parameters)
+{
+	using namespace QuickStatsStreamingFeedTest;
+
+	static constexpr int32 FramesPerPacket = 4;
+	static constexpr int32 NumFrames = 64;
+	static constexpr uint64 FirstFrameNumber = 1000;
+	static constexpr double TimeoutSeconds = 10.;
+
+	// port 0 lets the system pick a free one
+	FQuickStatsStreamingFeed Feed(0, false, FramesPerPacket);
+	if (!TestTrue(TEXT("Feed listens"), Feed.IsValid()))
+	{
+		return false;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+	Address->SetLoopbackAddress();
+	Address->SetPort(Feed.GetPort());
+
+	FSocket* Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("QuickStatsStreamTest"), false);
+	ON_SCOPE_EXIT
+	{
+		if (Socket)
+		{
+			Socket->Close();
+			SocketSubsystem->DestroySocket(Socket);
+		}
+	};
+	if (!TestTrue(TEXT("Client connects"), Socket && Socket->Connect(*Address)))
+	{
+		return false;
+	}
+
+	// frames are only queued once the feed accepted the client
+	const double StartTime = FPlatformTime::Seconds();
+	while (!Feed.IsActive() && FPlatformTime::Seconds() - StartTime < TimeoutSeconds)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+	if (!TestTrue(TEXT("Feed accepts the client"), Feed.IsActive()))
+	{
+		return false;
+	}
+
+	TArray<FQuickStatsFeedStat> Stats;
+	for (const TCHAR* StatDescription : { TEXT("Count"), TEXT("Time"), TEXT("Constant"), TEXT("Sign") })
+	{
+		FQuickStatsFeedStat& Stat = Stats.AddDefaulted_GetRef();
+		Stat.PresetName = TEXT("Test");
+		Stat.StatDescription = StatDescription;
+	}
+	Feed.OnSchemaChanged(Stats);
+
+	TArray<TArray<double>> SentValues;
+	TArray<double> SentTimes;
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		TArray<double>& Values = SentValues.AddDefaulted_GetRef();
+		Values.Add(FrameIndex * 3);
+		Values.Add(16.6 + FMath::Sin(FrameIndex * 0.5));
+		Values.Add(42.);
+		Values.Add(FrameIndex % 2 ? -0. : std::numeric_limits<double>::quiet_NaN());
+		SentTimes.Add(100. + FrameIndex / 60.);
+
+		Feed.OnStatsEvaluated(FirstFrameNumber + FrameIndex, SentTimes.Last(), 16.6, Values);
+	}
+
+	FDecoder Decoder;
+	TArray<uint8> Received;
+	while (Decoder.bIsValid && Decoder.FrameNumbers.Num() < NumFrames && FPlatformTime::Seconds() - StartTime < TimeoutSeconds)
+	{
+		if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100)))
+		{
+			continue;
+		}
+
+		uint8 Buffer[4096];
+		int32 BytesRead = 0;
+		if (!Socket->Recv(Buffer, sizeof(Buffer), BytesRead) || BytesRead == 0)
+		{
+			break;
+		}
+		Received.Append(Buffer, BytesRead);
+		Decoder.Decode(Received);
+	}
+
+	TestTrue(TEXT("Stream decodes"), Decoder.bIsValid);
+	TestEqual(TEXT("Protocol version"), (int32)Decoder.ProtocolVersion, (int32)QuickStatsStream::ProtocolVersion);
+	TestEqual(TEXT("Stats in the schema"), Decoder.StatDescriptions.Num(), Stats.Num());
+	if (!TestEqual(TEXT("Received frames"), Decoder.FrameNumbers.Num(), NumFrames))
+	{
+		return false;
+	}
+
+	for (int32 FrameIndex = 0; FrameIndex < NumFrames; ++FrameIndex)
+	{
+		if (Decoder.FrameNumbers[FrameIndex] != FirstFrameNumber + FrameIndex)
+		{
+			AddError(FString::Printf(TEXT("Frame %d has frame number %llu, frames aren't contiguous"), FrameIndex, Decoder.FrameNumbers[FrameIndex]));
+			return false;
+		}
+
+		// time is sent in whole microseconds
+		TestEqual(FString::Printf(TEXT("Time of frame %d"), FrameIndex), Decoder.FrameTimes[FrameIndex], SentTimes[FrameIndex], 0.000001);
+
+		for (int32 StatIndex = 0; StatIndex < Stats.Num(); ++StatIndex)
+		{
+			const double Sent = SentValues[FrameIndex][StatIndex];
+			const double Decoded = Decoder.FrameValues[FrameIndex][StatIndex];
+			if (FMemory::Memcmp(&Sent, &Decoded, sizeof(double)) != 0)
+			{
+				AddError(FString::Printf(TEXT("Stat %s of frame %d decoded as %.17g, sent %.17g"), *Stats[StatIndex].StatDescription, FrameIndex, Decoded, Sent));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif //#if WITH_DEV_AUTOMATION_TESTS && STATS
@@ -0,0 +1,83 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "QuickStatsTests.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "QuickStatsSummary.h"
+#include "Math/RandomStream.h"
+
+// compares the streamed quantiles with exact quantiles of the same values, within 1% of the exact value
+static void TestQuantiles(FAutomationTestBase& Test, const TCHAR* What, TArray<double> Values)
+{
+	FQuickStatsSummary Summary;
+	for (double Value : Values)
+	{
+		Summary.Add(Value, 0.);
+	}
+
+	Values.Sort();
+	auto GetExactQuantile = [&Values](double Quantile) { return Values[FMath::RoundToInt(Quantile * (Values.Num() - 1))]; };
+
+	const double P50 = GetExactQuantile(0.5);
+	const double P95 = GetExactQuantile(0.95);
+	const double P99 = GetExactQuantile(0.99);
+	Test.TestEqual(FString::Printf(TEXT("%s: P50"), What), Summary.P50.Get(), P50, FMath::Abs(P50) * 0.01);
+	Test.TestEqual(FString::Printf(TEXT("%s: P95"), What), Summary.P95.Get(), P95, FMath::Abs(P95) * 0.01);
+	Test.TestEqual(FString::Printf(TEXT("%s: P99"), What), Summary.P99.Get(), P99, FMath::Abs(P99) * 0.01);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuickStatsSummaryTest, "QuickStats.Summary.Quantiles", QUICKSTATS_TEST_FLAGS)
+
+bool FQuickStatsSummaryTest::RunTest(const FString& Parameters)
+{
+	// fewer values than markers give exact quantiles
+	FQuickStatsQuantile Median(0.5);
+	FQuickStatsQuantile P99(0.99);
+	TestEqual(TEXT("No values"), Median.Get(), 0.);
+	for (double Value : { 5., 1., 3. })
+	{
+		Median.Add(Value);
+		P99.Add(Value);
+	}
+	TestEqual(TEXT("Median of few values"), Median.Get(), 3.);
+	TestEqual(TEXT("P99 of few values"), P99.Get(), 5.);
+
+	FRandomStream Random(1234);
+	const int32 NumValues = 20000;
+	TArray<double> Uniform;
+	TArray<double> FrameTimes;
+	TArray<double> Hitches;
+	TArray<double> Ramp;
+	for (int32 ValueIndex = 0; ValueIndex < NumValues; ++ValueIndex)
+	{
+		Uniform.Add(Random.GetFraction() * 10.);
+		// long tail like frame times
+		FrameTimes.Add(16. - 2. * FMath::Loge(1. - Random.GetFraction()));
+		// every tenth frame is a hitch, P95 and P99 are in the second mode
+		Hitches.Add((ValueIndex % 10 == 0) ? 33. + Random.GetFraction() : 16. + Random.GetFraction());
+		// values only ever grow, every value lands in the last cell
+		Ramp.Add(ValueIndex);
+	}
+	TestQuantiles(*this, TEXT("Uniform"), Uniform);
+	TestQuantiles(*this, TEXT("Frame times"), FrameTimes);
+	TestQuantiles(*this, TEXT("Hitches"), Hitches);
+	TestQuantiles(*this, TEXT("Ramp"), Ramp);
+
+	// invalid values are skipped, budget counts frames strictly over it
+	FQuickStatsSummary Summary;
+	const double NaN = std::numeric_limits<double>::quiet_NaN();
+	for (double Value : { 10., NaN, 20., 30., NaN, 40. })
+	{
+		Summary.Add(Value, 20.);
+	}
+	TestEqual(TEXT("Invalid values are skipped"), Summary.NumFrames, static_cast<int64>(4));
+	TestEqual(TEXT("Frames over budget"), Summary.NumOverBudgetFrames, static_cast<int64>(2));
+	TestEqual(TEXT("Min"), Summary.Min, 10.);
+	TestEqual(TEXT("Max"), Summary.Max, 40.);
+	TestEqual(TEXT("Mean"), Summary.GetMean(), 25.);
+
+	return true;
+}
+
+#endif //#if WITH_DEV_AUTOMATION_TESTS
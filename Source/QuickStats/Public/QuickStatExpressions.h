@@ -5,12 +5,51 @@
 #include "Engine/DeveloperSettings.h"
 #include "QuickStatExpressions.generated.h"
 
+/*
+* Engine globals behind `stat unit` and `stat rhi`, captured on the game thread at the end of a frame.
+* The globals only hold the last frame, frames evaluated later read their own snapshot.
+*/
+struct QUICKSTATS_API FQuickStatEngineSnapshot
+{
+	bool bIsValid = false;
+	double FrameTime = 0.;
+	double GameThreadTime = 0.;
+	double RenderThreadTime = 0.;
+	double RHIThreadTime = 0.;
+	double GPUTime = 0.;
+	double DrawCalls = 0.;
+	double PrimitivesDrawn = 0.;
+
+	static FQuickStatEngineSnapshot Capture();
+};
+
 struct QUICKSTATS_API FQuickStatEvaluationContext
 {
 #if STATS
 	const TMap<FName, const FComplexStatMessage*>& Stats;
 	const TMap<FName, const FComplexStatMessage*>& CounterStats;
 #endif
+	// engine globals of the evaluated frame, current values are read if not set
+	const FQuickStatEngineSnapshot* EngineSnapshot = nullptr;
+};
+
+UENUM()
+enum class EQuickStatUnit : uint8
+{
+	// Use unit of the stat expression
+	Auto,
+	Count,
+	Milliseconds,
+	Bytes,
+	Percent,
+};
+
+struct QUICKSTATS_API FQuickStatUnits
+{
+	/*
+	* Formats value for display, milliseconds below 1ms are shown in microseconds and bytes are scaled up to GB.
+	*/
+	static FString FormatValue(double Value, EQuickStatUnit Unit);
 };
 
 UCLASS(Abstract, BlueprintType, EditInlineNew, CollapseCategories)
@@ -24,6 +63,16 @@ public:
 	*/
 	virtual TSet<FName> GetRequiredStatGroupNames() const { return TSet<FName>{}; }
 
+	/*
+	* Stats read by this stat expression.
+	*/
+	virtual TSet<FName> GetRequiredStatNames() const { return TSet<FName>{}; }
+
+	/*
+	* Unit of the evaluated value, units of code stats are only known while evaluating.
+	*/
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const { return EQuickStatUnit::Count; }
+
 	/*
 	* Evaluates a stat expression and returns true if expression is valid.
 	*/
@@ -38,11 +87,15 @@ class QUICKSTATS_API UQuickStatExpressionConstant : public UQuickStatExpression
 	GENERATED_BODY()
 
 public:
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override { return (Unit != EQuickStatUnit::Auto) ? Unit : EQuickStatUnit::Count; }
 	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override { OutResult = Constant; return true; }
 
 public:
 	UPROPERTY(EditAnywhere, Category = "QuickStatExpression")
 	double Constant = 0.;
+
+	UPROPERTY(EditAnywhere, Category = "QuickStatExpression")
+	EQuickStatUnit Unit = EQuickStatUnit::Count;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +121,18 @@ class QUICKSTATS_API UQuickStatExpressionReadStat : public UQuickStatExpression
 
 public:
 	virtual TSet<FName> GetRequiredStatGroupNames() const { return TSet<FName>{ StatDefinition.StatGroupName }; }
+	virtual TSet<FName> GetRequiredStatNames() const override { return TSet<FName>{ StatDefinition.StatName }; }
+
+	/*
+	* Reads value of a cycle stat (ms) or counter, returns false if the stat is not available.
+	*/
+	static bool ReadStatValue(const FQuickStatEvaluationContext& Context, FName StatName, double& OutValue);
+
+	/*
+	* Cycle stats are in ms, memory counters in bytes.
+	*/
+	static EQuickStatUnit ReadStatUnit(const FQuickStatEvaluationContext& Context, FName StatName);
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override { return ReadStatUnit(Context, StatDefinition.StatName); }
 
 	/*
 	* Expression can be invalid if 
@@ -96,6 +161,8 @@ public:
 	UQuickStatExpressionAdd();
 
 	virtual TSet<FName> GetRequiredStatGroupNames() const override;
+	virtual TSet<FName> GetRequiredStatNames() const override;
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override;
 	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
 
 public:
@@ -112,6 +179,8 @@ class QUICKSTATS_API UQuickStatExpressionSubtract : public UQuickStatExpression
 
 public:
 	virtual TSet<FName> GetRequiredStatGroupNames() const override;
+	virtual TSet<FName> GetRequiredStatNames() const override;
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override;
 	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
 
 public:
@@ -133,6 +202,8 @@ public:
 	UQuickStatExpressionMultiply();
 
 	virtual TSet<FName> GetRequiredStatGroupNames() const override;
+	virtual TSet<FName> GetRequiredStatNames() const override;
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override;
 	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
 
 public:
@@ -149,6 +220,8 @@ class QUICKSTATS_API UQuickStatExpressionDivide : public UQuickStatExpression
 
 public:
 	virtual TSet<FName> GetRequiredStatGroupNames() const override;
+	virtual TSet<FName> GetRequiredStatNames() const override;
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override;
 	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
 
 public:
@@ -158,3 +231,67 @@ public:
 	UPROPERTY(EditAnywhere, Instanced, Category = "QuickStatExpression")
 	UQuickStatExpression* InputB = nullptr;
 };
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+UENUM()
+enum class EQuickStatPlatformMemoryStat : uint8
+{
+	UsedPhysical,
+	PeakUsedPhysical,
+	AvailablePhysical,
+	UsedVirtual,
+	PeakUsedVirtual,
+	AvailableVirtual,
+};
+
+UCLASS(meta = (DisplayName = "Platform Memory"))
+class QUICKSTATS_API UQuickStatExpressionPlatformMemory : public UQuickStatExpression
+{
+	GENERATED_BODY()
+
+public:
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override { return EQuickStatUnit::Bytes; }
+
+	/*
+	* Reads process memory from FPlatformMemory::GetStats, doesn't need any stat group.
+	*/
+	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
+
+public:
+	UPROPERTY(EditAnywhere, Category = "QuickStatExpression")
+	EQuickStatPlatformMemoryStat MemoryStat = EQuickStatPlatformMemoryStat::UsedPhysical;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+UENUM()
+enum class EQuickStatEngineStat : uint8
+{
+	FrameTime,
+	GameThreadTime,
+	RenderThreadTime,
+	RHIThreadTime,
+	GPUTime,
+	DrawCalls,
+	PrimitivesDrawn,
+};
+
+UCLASS(meta = (DisplayName = "Engine Stat"))
+class QUICKSTATS_API UQuickStatExpressionEngineStat : public UQuickStatExpression
+{
+	GENERATED_BODY()
+
+public:
+	virtual EQuickStatUnit GetUnit(const FQuickStatEvaluationContext& Context) const override;
+
+	/*
+	* Reads engine globals behind `stat unit` and `stat rhi` from the snapshot of the evaluated frame, doesn't need any stat group.
+	* GPU values are zero with -nullrhi.
+	*/
+	virtual bool Evaluate(const FQuickStatEvaluationContext& Context, double& OutResult) const override;
+
+public:
+	UPROPERTY(EditAnywhere, Category = "QuickStatExpression")
+	EQuickStatEngineStat EngineStat = EQuickStatEngineStat::FrameTime;
+};
@@ -5,8 +5,38 @@
 #include "Engine/DeveloperSettings.h"
 #include "QuickStatExpressions.h"
 #include "Engine/DataAsset.h"
+#include "Engine/EngineTypes.h"
 #include "QuickStatSettings.generated.h"
 
+UENUM()
+enum class EQuickStatRefreshAggregation : uint8
+{
+	// Display the value evaluated on the refresh frame, stats are not evaluated between refreshes
+	Latest,
+	// Display average of all the frames since last refresh
+	Mean,
+	// Display maximum of all the frames since last refresh, spikes between refreshes are still visible
+	Max,
+};
+
+UENUM()
+enum class EQuickStatPresetDisplayMode : uint8
+{
+	// One row per stat
+	Rows,
+	// Stats stacked in a single bar against the preset's budget, followed by a row per stat with its share of the total
+	StackedBar,
+};
+
+UENUM()
+enum class EQuickStatBaselineMetric : uint8
+{
+	Mean,
+	P50,
+	P95,
+	P99,
+};
+
 USTRUCT()
 struct QUICKSTATS_API FQuickStat
 {
@@ -20,14 +50,34 @@ struct QUICKSTATS_API FQuickStat
 	UPROPERTY(EditAnywhere, Instanced, Category = "Quick Stat")
 	UQuickStatExpression* StatExpression = nullptr;
 
+	// Unit used to format the value, Auto uses unit of the expression (ms for cycle stats, bytes for memory stats)
+	UPROPERTY(EditAnywhere, Category = "Quick Stat")
+	EQuickStatUnit Unit = EQuickStatUnit::Auto;
+
 	/*
-	Budget allocated to the stat, used for coloring.
+	Budget allocated to the stat (in the unit of the stat), used for coloring.
 	> Budget		= Red
 	> 75% of Budget	= Yellow
 	< 75% of Budget	= Green
 	*/
 	UPROPERTY(EditAnywhere, Category = "Quick Stat")
 	double Budget = 0.;
+
+	// Seconds between evaluations for slowly changing stats (memory, object counts), last value is displayed and captured in between. 0 evaluates every frame
+	UPROPERTY(EditAnywhere, Category = "Quick Stat", meta = (ClampMin = "0"))
+	float SamplingPeriod = 0.f;
+
+	// Allowed increase over the baseline (percent) before the stat counts as a regression, 0 uses QuickStatSettings::BaselineTolerance
+	UPROPERTY(EditAnywhere, Category = "Quick Stat", meta = (ClampMin = "0"))
+	float RegressionTolerance = 0.f;
+
+	// Increase over the baseline (in the unit of the stat) that never counts as a regression, 0 uses QuickStatSettings::BaselineAbsoluteTolerance
+	UPROPERTY(EditAnywhere, Category = "Quick Stat", meta = (ClampMin = "0"))
+	float RegressionAbsoluteTolerance = 0.f;
+
+	// Flag spikes and level shifts of the stat without a budget, the stat is evaluated every frame even when not displayed
+	UPROPERTY(EditAnywhere, Category = "Quick Stat")
+	bool DetectAnomalies = false;
 };
 
 UCLASS()
@@ -38,6 +88,22 @@ class QUICKSTATS_API UQuickStatPreset : public UDataAsset
 public:
 	UPROPERTY(EditAnywhere, Category = "Stat Preset")
 	TArray<FQuickStat> StatsToDisplay;
+
+	// Number of times per second stat values are refreshed, overrides QuickStatSettings::RefreshRate if > 0
+	UPROPERTY(EditAnywhere, Category = "Stat Preset", meta = (ClampMin = "0"))
+	float RefreshRate = 0.f;
+
+	// Record stats as CSV profiler custom stats (QuickStats category) while a CSV capture is running
+	UPROPERTY(EditAnywhere, Category = "Stat Preset")
+	bool RecordToCsv = false;
+
+	// How stats of the preset are displayed
+	UPROPERTY(EditAnywhere, Category = "Stat Preset")
+	EQuickStatPresetDisplayMode DisplayMode = EQuickStatPresetDisplayMode::Rows;
+
+	// Total budget the stacked bar is drawn against, 0 uses the sum of stat budgets. Stats over their own budget are outlined in red
+	UPROPERTY(EditAnywhere, Category = "Stat Preset", meta = (EditCondition = "DisplayMode == EQuickStatPresetDisplayMode::StackedBar", ClampMin = "0"))
+	double BarBudget = 0.;
 };
 
 UCLASS(config = QuickStats, defaultconfig, meta = (DisplayName = "Quick Stats"))
@@ -60,6 +126,14 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Stats")
 	TMap<FName, TSoftObjectPtr<UQuickStatPreset>> StatPresets;
 
+	// Number of times per second stat values are refreshed, 0 refreshes every frame
+	UPROPERTY(config, EditAnywhere, Category = "Stats", meta = (ClampMin = "0"))
+	float RefreshRate = 0.f;
+
+	// How values evaluated between refreshes are combined
+	UPROPERTY(config, EditAnywhere, Category = "Stats")
+	EQuickStatRefreshAggregation RefreshAggregation = EQuickStatRefreshAggregation::Latest;
+
 	// Horizontal offset to start stat rendering
 	UPROPERTY(config, EditAnywhere, Category = "Layout")
 	int32 ViewportOffsetX = -50;
@@ -84,6 +158,137 @@ public:
 	UPROPERTY(config, EditAnywhere, Category = "Layout")
 	bool ShowPresetNames = true;
 
+	// Draw stats using a retained Slate widget which only repaints when a displayed value changes (game viewports only)
+	UPROPERTY(config, EditAnywhere, Category = "Layout")
+	bool UseSlateOverlay = false;
+
+	// Publish values of all evaluated stats to a shared memory ring buffer (QuickStatsFeedLayout.h) for external tools
+	UPROPERTY(config, EditAnywhere, Category = "Feeds")
+	bool PublishSharedMemoryFeed = false;
+
+	// Stream values of all evaluated stats over TCP (QuickStatsStreamProtocol.h) for remote viewers
+	UPROPERTY(config, EditAnywhere, Category = "Feeds")
+	bool StreamStats = false;
+
+	// Port the streaming server listens on
+	UPROPERTY(config, EditAnywhere, Category = "Feeds", meta = (EditCondition = "StreamStats", ClampMin = "1", ClampMax = "65535"))
+	int32 StreamingPort = 7272;
+
+	// Accept viewers from other machines, otherwise only localhost can connect
+	UPROPERTY(config, EditAnywhere, Category = "Feeds", meta = (EditCondition = "StreamStats"))
+	bool StreamingListenOnAllInterfaces = false;
+
+	// Number of frames sent in a single packet
+	UPROPERTY(config, EditAnywhere, Category = "Feeds", meta = (EditCondition = "StreamStats", ClampMin = "1", ClampMax = "255"))
+	int32 StreamingFramesPerPacket = 4;
+
+	// Dump values of all evaluated stats around hitches to Saved/QuickStats/Hitches
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture")
+	bool CaptureHitches = false;
+
+	// Frame time (ms) considered a hitch, 0 to only capture stats going over budget
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture", meta = (EditCondition = "CaptureHitches", ClampMin = "0"))
+	float HitchFrameTimeThreshold = 100.f;
+
+	// Capture when any stat goes over its budget
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture", meta = (EditCondition = "CaptureHitches"))
+	bool HitchOnOverBudget = false;
+
+	// Number of frames recorded before the hitch
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture", meta = (EditCondition = "CaptureHitches", ClampMin = "0", ClampMax = "1000"))
+	int32 HitchPreRollFrames = 60;
+
+	// Number of frames recorded after the hitch
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture", meta = (EditCondition = "CaptureHitches", ClampMin = "0", ClampMax = "1000"))
+	int32 HitchPostRollFrames = 30;
+
+	// Minimum seconds between captures, hitches during cooldown are ignored
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Hitch Capture", meta = (EditCondition = "CaptureHitches", ClampMin = "0"))
+	float HitchCooldown = 5.f;
+
+	// Record values of all evaluated stats to compressed columnar captures (.qscap) in Saved/QuickStats/Captures, also enabled by -qstatscapture
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Capture")
+	bool RecordCapture = false;
+
+	// A capture file is written and a new one started after this many frames, 0 for no limit
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Capture", meta = (EditCondition = "RecordCapture", ClampMin = "0"))
+	int32 CaptureSegmentFrames = 18000;
+
+	// A capture file is written and a new one started once its compressed columns reach this size (MB), 0 for no limit
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Capture", meta = (EditCondition = "RecordCapture", ClampMin = "0"))
+	int32 CaptureSegmentSize = 16;
+
+	// Bin evaluated stats by camera position into a grid of cells (mean and max per cell), exported to Saved/QuickStats/Heatmaps with qstats.ExportHeatmap and on exit. Also enabled by -qstatsheatmap
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Heatmap")
+	bool RecordHeatmap = false;
+
+	// Size of a cell (cm)
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Heatmap", meta = (EditCondition = "RecordHeatmap", ClampMin = "1"))
+	float HeatmapCellSize = 1000.f;
+
+	// Bin camera height as well, otherwise cells are columns covering all heights
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Heatmap", meta = (EditCondition = "RecordHeatmap"))
+	bool HeatmapIncludeHeight = false;
+
+	// Track correlation of every evaluated stat with a target stat over a sliding window, printed with qstats.Correlate
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Correlation")
+	bool AnalyzeCorrelation = false;
+
+	// Number of frames in the sliding window
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Correlation", meta = (EditCondition = "AnalyzeCorrelation", ClampMin = "2", ClampMax = "10000"))
+	int32 CorrelationWindow = 300;
+
+	// Stat the others are correlated with as "Preset/Stat description", empty uses frame time. Can be changed with qstats.CorrelationTarget
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Correlation", meta = (EditCondition = "AnalyzeCorrelation"))
+	FString CorrelationTarget;
+
+	// Summarize evaluated stats over the session (min/max/mean/percentiles/frames over budget), written with qstats.Report.
+	// Every stat is evaluated every frame while recording, -qstatsreport enables recording and writing on exit for a single run
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Session Report")
+	bool RecordSessionReport = false;
+
+	// Write session report to Saved/QuickStats/Reports on exit
+	UPROPERTY(config, EditAnywhere, Category = "Feeds|Session Report", meta = (EditCondition = "RecordSessionReport"))
+	bool WriteSessionReportOnExit = false;
+
+	// Number of frames the mean and deviation used for anomaly detection cover, stats aren't flagged during the first window
+	UPROPERTY(config, EditAnywhere, Category = "Anomaly Detection", meta = (ClampMin = "2", ClampMax = "10000"))
+	int32 AnomalyWindow = 120;
+
+	// Standard deviations from the mean for a single value to be flagged as a spike
+	UPROPERTY(config, EditAnywhere, Category = "Anomaly Detection", meta = (ClampMin = "1"))
+	float AnomalyZScore = 5.f;
+
+	// CUSUM threshold (sum of standard deviations) for a sustained change to be flagged as a level shift, lower values catch smaller shifts
+	UPROPERTY(config, EditAnywhere, Category = "Anomaly Detection", meta = (ClampMin = "1"))
+	float ChangePointThreshold = 8.f;
+
+	// Seconds a flagged stat stays highlighted in the overlay
+	UPROPERTY(config, EditAnywhere, Category = "Anomaly Detection", meta = (ClampMin = "0"))
+	float AnomalyHighlightDuration = 5.f;
+
+	// Session report of an earlier run, stats are colored by their change from it instead of the budget. Overridden by -qstatsbaseline=
+	UPROPERTY(config, EditAnywhere, Category = "Baseline", meta = (FilePathFilter = "json"))
+	FFilePath BaselineFile;
+
+	// Value of the baseline compared against, the session report uses the same metric for regression checks
+	UPROPERTY(config, EditAnywhere, Category = "Baseline")
+	EQuickStatBaselineMetric BaselineMetric = EQuickStatBaselineMetric::Mean;
+
+	// Allowed increase over the baseline (percent) for stats which don't set their own tolerance
+	UPROPERTY(config, EditAnywhere, Category = "Baseline", meta = (ClampMin = "0"))
+	float BaselineTolerance = 10.f;
+
+	// Increase over the baseline (in the unit of the stat) that never counts as a regression, for stats which don't set their own.
+	// A stat has to exceed both tolerances, so stats with a baseline near zero (culled primitives, idle counters) don't regress on noise
+	UPROPERTY(config, EditAnywhere, Category = "Baseline", meta = (ClampMin = "0"))
+	float BaselineAbsoluteTolerance = 1.f;
+
+	// Exit with a non-zero code if any stat regressed or a stat of the baseline wasn't evaluated, only for unattended or -nullrhi runs.
+	// These runs record the session and evaluate the enabled presets without a viewport while a baseline is loaded
+	UPROPERTY(config, EditAnywhere, Category = "Baseline")
+	bool FailOnRegression = true;
+
 private:
 	UPROPERTY(Transient)
 	TMap<FName, TObjectPtr<UQuickStatPreset>> LoadedStatPresets;
@@ -0,0 +1,71 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+/*
+* Columnar file format of QuickStats captures (.qscap), written by the capture feed and read by FQuickStatsCaptureReader.
+* This header doesn't depend on engine types. All integers are little-endian.
+*
+* File:		FHeader, FStat[NumStats], Strings, column data
+*
+* Every column holds NumFrames values, the frame index (frame numbers and microseconds since the first frame) is stored
+* as two more columns. Columns are independent, a single stat can be decoded without touching the others.
+*
+* DeltaVarint:	per value varint (ZigZag(Value - PreviousValue) + 1), 0 marks an invalid (NaN) value and keeps the previous value.
+*				Used while all the values of the column are integers (counts, bytes, frame numbers).
+* XorFloat:		bit stream (most significant bit first) of the double bits XOR-ed with the previous value, first value is stored as is.
+*				'0'										same as the previous value
+*				'10', meaningful bits					XOR fits the window of the previous value
+*				'11', 5 bits leading zeros, 6 bits (meaningful bit count - 1), meaningful bits
+*/
+
+#include <stdint.h>
+
+namespace QuickStatsCapture
+{
+	static constexpr const char* FileExtension = ".qscap";
+
+	static constexpr uint32_t Magic = 0x46435351; // 'QSCF'
+	static constexpr uint32_t Version = 1;
+
+	enum class EColumnEncoding : uint8_t
+	{
+		DeltaVarint = 0,
+		XorFloat = 1,
+	};
+
+	struct FColumn
+	{
+		// from the start of the file
+		uint64_t Offset;
+		uint64_t Size;
+		EColumnEncoding Encoding;
+		uint8_t Padding[7];
+	};
+
+	struct FStat
+	{
+		double Budget;
+		// offsets of null terminated utf-8 strings in Strings
+		uint32_t PresetNameOffset;
+		uint32_t StatDescriptionOffset;
+		FColumn Values;
+	};
+
+	struct FHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t NumStats;
+		uint32_t NumFrames;
+		// FDateTime ticks (UTC) of the first frame
+		int64_t StartTimeTicks;
+		FColumn FrameNumbers;
+		// microseconds since the first frame
+		FColumn FrameTimes;
+		uint64_t StringsOffset;
+		uint64_t StringsSize;
+	};
+
+	static_assert(sizeof(FColumn) == 24 && sizeof(FStat) == 40 && sizeof(FHeader) == 88, "Capture structs are written as is, they must not have implicit padding.");
+}
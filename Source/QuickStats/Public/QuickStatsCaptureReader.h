@@ -0,0 +1,68 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuickStatsCaptureFormat.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+* Reads capture files (QuickStatsCaptureFormat.h) written by the capture feed.
+* The file is memory-mapped and only the header and schema are read when opened, columns are decoded on demand,
+* so scanning a single stat across many captures only touches the pages of that stat.
+*/
+class QUICKSTATS_API FQuickStatsCaptureReader
+{
+public:
+	~FQuickStatsCaptureReader();
+
+	// returns nullptr if the file can't be read or isn't a valid capture
+	static TUniquePtr<FQuickStatsCaptureReader> Open(const FString& FilePath);
+
+	int32 GetNumStats() const { return Stats.Num(); }
+	int32 GetNumFrames() const { return Header.NumFrames; }
+	// UTC time of the first frame
+	FDateTime GetStartTime() const { return FDateTime(Header.StartTimeTicks); }
+
+	FName GetPresetName(int32 StatIndex) const { return PresetNames[StatIndex]; }
+	const FString& GetStatDescription(int32 StatIndex) const { return StatDescriptions[StatIndex]; }
+	double GetBudget(int32 StatIndex) const { return Stats[StatIndex].Budget; }
+
+	// INDEX_NONE if the stat wasn't captured
+	int32 FindStat(FName PresetName, const FString& StatDescription) const;
+
+	// decodes values of the stat in frame order without storing them, NaN if the stat couldn't be evaluated
+	// returns false if the column is malformed
+	bool ForEachStatValue(int32 StatIndex, TFunctionRef<void(int32 FrameIndex, double Value)> Visitor) const;
+	bool ReadStatValues(int32 StatIndex, TArray<double>& OutValues) const;
+
+	// frame index of the capture
+	bool ReadFrameNumbers(TArray<uint64>& OutFrameNumbers) const;
+	// seconds since the first frame
+	bool ReadFrameTimes(TArray<double>& OutFrameTimes) const;
+
+private:
+	FQuickStatsCaptureReader() = default;
+
+	bool ParseHeader();
+	bool IsColumnValid(const QuickStatsCapture::FColumn& Column) const;
+	bool ForEachValue(const QuickStatsCapture::FColumn& Column, TFunctionRef<void(int32 FrameIndex, double Value)> Visitor) const;
+
+private:
+	FString FilePath;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	// used if the platform can't map files
+	TArray<uint8> FileData;
+
+	const uint8* Data = nullptr;
+	uint64 Size = 0;
+
+	QuickStatsCapture::FHeader Header;
+	TArray<QuickStatsCapture::FStat> Stats;
+	TArray<FName> PresetNames;
+	TArray<FString> StatDescriptions;
+};
@@ -0,0 +1,81 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+/*
+* Layout of the shared memory region QuickStats publishes evaluated stats to.
+* This header doesn't depend on engine types, so standalone tools can include it (see Extras/QuickStatsFeedReader).
+*
+* Region is written by a single writer (game thread) and can be read by any number of processes.
+* Schema and frame slots are guarded by sequence numbers (seqlock), the writer makes the sequence odd while writing
+* and even once done, readers access the data in place and retry if the sequence changed.
+*/
+
+#include <atomic>
+#include <stdint.h>
+
+namespace QuickStatsFeed
+{
+	// Named region, POSIX platforms prefix it with '/'
+	static constexpr const char* RegionName = "QuickStatsFeed";
+
+	static constexpr uint32_t Magic = 0x44465351; // 'QSFD'
+	static constexpr uint32_t Version = 1;
+
+	static constexpr uint32_t MaxStats = 256;
+	static constexpr uint32_t MaxFrames = 256;
+	static constexpr uint32_t MaxNameLength = 64;
+
+	struct FStatSchema
+	{
+		double Budget;
+		// null terminated utf-8 strings
+		char PresetName[MaxNameLength];
+		char StatDescription[MaxNameLength];
+	};
+
+	struct FSchema
+	{
+		// odd while the writer is updating the schema, frames store the sequence of the schema they were written with
+		std::atomic<uint64_t> Sequence;
+		uint32_t NumStats;
+		uint32_t Padding;
+		FStatSchema Stats[MaxStats];
+	};
+
+	struct FFrame
+	{
+		// odd while the writer is updating the frame
+		std::atomic<uint64_t> Sequence;
+		uint64_t SchemaSequence;
+		uint64_t FrameNumber;
+		// seconds, FPlatformTime::Seconds of the writer
+		double Time;
+		uint32_t NumValues;
+		uint32_t Padding;
+		// NaN if the stat couldn't be evaluated
+		double Values[MaxStats];
+	};
+
+	struct FHeader
+	{
+		// set once the region is initialized, cleared when the writer shuts down
+		std::atomic<uint32_t> Magic;
+		uint32_t Version;
+		uint32_t MaxStats;
+		uint32_t MaxFrames;
+		uint32_t WriterProcessId;
+		uint32_t Padding;
+		// total number of frames written, frame N is stored in Frames[N % MaxFrames]
+		std::atomic<uint64_t> NumFramesWritten;
+	};
+
+	struct FRegion
+	{
+		FHeader Header;
+		FSchema Schema;
+		FFrame Frames[MaxFrames];
+	};
+
+	static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Atomics in shared memory must not carry extra state.");
+}
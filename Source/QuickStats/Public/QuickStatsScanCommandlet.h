@@ -0,0 +1,21 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "QuickStatsScanCommandlet.generated.h"
+
+/*
+* Summarizes one stat across many captures, only the column of that stat is decoded.
+* -run=QuickStatsScan -Captures=<Directory> -Preset=<PresetName> -Stat="<StatDescription>" [-Out=<File.csv>]
+*/
+UCLASS()
+class UQuickStatsScanCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UQuickStatsScanCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,73 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+/*
+* Wire format of the QuickStats TCP stream, used by the streaming server and by remote viewers (see Extras/QuickStatsStreamClient).
+* This header doesn't depend on engine types. All integers are little-endian.
+*
+* Message:	uint32 PayloadSize, uint8 MessageType, Payload
+*
+* Hello:	uint32 ProtocolVersion
+* Schema:	uint32 SchemaId, uint16 NumStats, per stat { double Budget, uint8 Length, utf-8 PresetName, uint8 Length, utf-8 StatDescription }
+* Values:	uint32 SchemaId, uint8 Flags, uint16 NumFrames, per frame {
+*				varint FrameNumber, varint TimeMicroseconds	(absolute for the first frame of a key frame packet, delta from previous frame otherwise)
+*				uint8 ChangedMask[(NumStats + 7) / 8]
+*				per changed stat { uint8 TrailingZeros, varint (Bits ^ PreviousBits) >> TrailingZeros }
+*			}
+*
+* Values are delta encoded by XOR-ing the bits of the double with the bits of the previous frame,
+* key frames start from zero so clients connecting mid-stream can decode them.
+*/
+
+#include <stdint.h>
+
+namespace QuickStatsStream
+{
+	static constexpr uint16_t DefaultPort = 7272;
+	static constexpr uint32_t ProtocolVersion = 1;
+
+	static constexpr uint32_t MessageHeaderSize = 5;
+	static constexpr uint32_t MaxVarintSize = 10;
+
+	enum class EMessageType : uint8_t
+	{
+		Hello = 0,
+		Schema = 1,
+		Values = 2,
+	};
+
+	enum EValuesFlags : uint8_t
+	{
+		KeyFrame = 1 << 0,
+	};
+
+	// Returns number of bytes written, Dest needs MaxVarintSize bytes.
+	inline uint32_t WriteVarint(uint8_t* Dest, uint64_t Value)
+	{
+		uint32_t Size = 0;
+		while (Value >= 0x80)
+		{
+			Dest[Size++] = static_cast<uint8_t>(Value | 0x80);
+			Value >>= 7;
+		}
+		Dest[Size++] = static_cast<uint8_t>(Value);
+		return Size;
+	}
+
+	// Returns pointer past the varint, nullptr if the varint is truncated or malformed.
+	inline const uint8_t* ReadVarint(const uint8_t* Src, const uint8_t* End, uint64_t& OutValue)
+	{
+		OutValue = 0;
+		for (uint32_t Shift = 0; Shift < 64 && Src < End; Shift += 7)
+		{
+			const uint8_t Byte = *Src++;
+			OutValue |= static_cast<uint64_t>(Byte & 0x7f) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return Src;
+			}
+		}
+		return nullptr;
+	}
+}
@@ -14,9 +14,22 @@ public class QuickStats : ModuleRules
 				"Core",
 				"CoreUObject",
 				"Engine",
+				"RenderCore",
+				"RHI",
+				"Slate",
+				"SlateCore",
+				"Sockets",
 				"DeveloperSettings",
+				"Json",
+				"ImageWrapper",
 				"EngineSettings"
 			}
 		);
+
+		// views of editor viewports are removed when their viewport client unregisters
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+		}
 	}
 }
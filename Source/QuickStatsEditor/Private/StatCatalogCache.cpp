@@ -0,0 +1,206 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "StatCatalogCache.h"
+
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/EngineVersion.h"
+#include "HAL/FileManager.h"
+#include "Hash/CityHash.h"
+#include "Interfaces/IPluginManager.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace StatCatalogCache
+{
+	static constexpr uint32 Magic = 0x43535351; // "QSSC"
+	static constexpr uint32 Version = 2;
+	// serialized FString length
+	static constexpr int64 MinNameSize = sizeof(int32);
+}
+
+bool FStatCatalogCache::Load(TMap<FName, TArray<FName>>& OutStatGroups, TSet<FName>& OutModuleNames)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetCacheFilePath(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(FileData);
+
+	uint32 Magic = 0, Version = 0;
+	uint64 BuildKey = 0;
+	Reader << Magic << Version << BuildKey;
+	if (Reader.IsError() || Magic != StatCatalogCache::Magic || Version != StatCatalogCache::Version || BuildKey != GetBuildKey())
+	{
+		return false;
+	}
+
+	// every name takes at least its length, so counts larger than what is left of the file are corrupted
+	const auto IsCountValid = [&Reader](int32 Count, int64 MinEntrySize)
+	{
+		return !Reader.IsError() && Count >= 0 && Count <= (Reader.TotalSize() - Reader.Tell()) / MinEntrySize;
+	};
+
+	int32 NumModules = 0;
+	Reader << NumModules;
+	if (!IsCountValid(NumModules, StatCatalogCache::MinNameSize))
+	{
+		return false;
+	}
+
+	OutModuleNames.Reset();
+	OutModuleNames.Reserve(NumModules);
+
+	FString NameString;
+	for (int32 ModuleIndex = 0; ModuleIndex < NumModules && !Reader.IsError(); ++ModuleIndex)
+	{
+		Reader << NameString;
+		OutModuleNames.Add(FName(NameString));
+	}
+
+	int32 NumStatGroups = 0;
+	Reader << NumStatGroups;
+	if (!IsCountValid(NumStatGroups, StatCatalogCache::MinNameSize + sizeof(int32)))
+	{
+		return false;
+	}
+
+	OutStatGroups.Reset();
+	OutStatGroups.Reserve(NumStatGroups);
+
+	for (int32 GroupIndex = 0; GroupIndex < NumStatGroups && !Reader.IsError(); ++GroupIndex)
+	{
+		int32 NumStats = 0;
+		Reader << NameString << NumStats;
+		if (!IsCountValid(NumStats, StatCatalogCache::MinNameSize))
+		{
+			Reader.SetError();
+			break;
+		}
+
+		TArray<FName>& StatNames = OutStatGroups.Add(FName(NameString));
+		StatNames.Reserve(NumStats);
+		for (int32 StatIndex = 0; StatIndex < NumStats && !Reader.IsError(); ++StatIndex)
+		{
+			Reader << NameString;
+			StatNames.Add(FName(NameString));
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		OutStatGroups.Reset();
+		OutModuleNames.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FStatCatalogCache::Save(const TMap<FName, TArray<FName>>& StatGroups, const TSet<FName>& ModuleNames)
+{
+	TArray<uint8> FileData;
+	FMemoryWriter Writer(FileData);
+
+	uint32 Magic = StatCatalogCache::Magic;
+	uint32 Version = StatCatalogCache::Version;
+	uint64 BuildKey = GetBuildKey();
+	Writer << Magic << Version << BuildKey;
+
+	int32 NumModules = ModuleNames.Num();
+	Writer << NumModules;
+	for (FName ModuleName : ModuleNames)
+	{
+		FString NameString = ModuleName.ToString();
+		Writer << NameString;
+	}
+
+	int32 NumStatGroups = StatGroups.Num();
+	Writer << NumStatGroups;
+
+	// names are stored as strings, FString serialization already stores ANSI names as single byte characters
+	for (const auto& Itr : StatGroups)
+	{
+		FString NameString = Itr.Key.ToString();
+		int32 NumStats = Itr.Value.Num();
+		Writer << NameString << NumStats;
+
+		for (FName StatName : Itr.Value)
+		{
+			NameString = StatName.ToString();
+			Writer << NameString;
+		}
+	}
+
+	if (!FFileHelper::SaveArrayToFile(FileData, *GetCacheFilePath()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[QuickStat] Failed to write stat catalog cache(%s)!"), *GetCacheFilePath());
+	}
+}
+
+void FStatCatalogCache::GetLoadedModuleNames(TSet<FName>& OutModuleNames)
+{
+	TArray<FModuleStatus> ModuleStatuses;
+	FModuleManager::Get().QueryModules(ModuleStatuses);
+
+	OutModuleNames.Reset();
+	for (const FModuleStatus& ModuleStatus : ModuleStatuses)
+	{
+		if (ModuleStatus.bIsLoaded)
+		{
+			OutModuleNames.Add(FName(*ModuleStatus.Name));
+		}
+	}
+}
+
+FString FStatCatalogCache::GetCacheFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("QuickStats") / TEXT("StatCatalog.bin");
+}
+
+uint64 FStatCatalogCache::GetBuildKey()
+{
+	static const uint64 BuildKey = ComputeBuildKey();
+	return BuildKey;
+}
+
+uint64 FStatCatalogCache::ComputeBuildKey()
+{
+	// engine build
+	FString KeyString = FEngineVersion::Current().ToString();
+	KeyString += FApp::GetBuildVersion();
+
+	// stats are declared by the code so rebuilding any module binary can add/remove stats.
+	// every binary that can declare stats is used instead of the loaded modules, so plugins loading later don't invalidate the cache
+	TArray<FString> BinariesDirs;
+	BinariesDirs.Add(FPlatformProcess::GetModulesDirectory());
+	BinariesDirs.Add(FPaths::ProjectDir() / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory());
+	for (const TSharedRef<IPlugin>& Plugin : IPluginManager::Get().GetEnabledPlugins())
+	{
+		BinariesDirs.Add(Plugin->GetBaseDir() / TEXT("Binaries") / FPlatformProcess::GetBinariesSubdirectory());
+	}
+	BinariesDirs.Sort();
+
+	const FString ModuleWildcard = FString(TEXT("*.")) + FPlatformProcess::GetModuleExtension();
+	TArray<FString> ModuleFileNames;
+	for (const FString& BinariesDir : BinariesDirs)
+	{
+		ModuleFileNames.Reset();
+		IFileManager::Get().FindFiles(ModuleFileNames, *(BinariesDir / ModuleWildcard), true, false);
+		ModuleFileNames.Sort();
+
+		for (const FString& ModuleFileName : ModuleFileNames)
+		{
+			KeyString += ModuleFileName;
+			KeyString += IFileManager::Get().GetTimeStamp(*(BinariesDir / ModuleFileName)).ToString();
+		}
+	}
+
+	// monolithic builds have everything in the executable
+	KeyString += IFileManager::Get().GetTimeStamp(FPlatformProcess::ExecutablePath()).ToString();
+
+	return CityHash64(reinterpret_cast<const char*>(*KeyString), KeyString.Len() * sizeof(TCHAR));
+}
@@ -0,0 +1,29 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Persists the StatGroupName -> StatNames catalog to Saved/QuickStats so the stat picker
+* doesn't need to run "stat group listall" every session.
+* Cache is keyed by engine version and the timestamps of the module binaries, any rebuild invalidates it.
+* Modules loaded while the stats were listed are stored too, stats of modules loaded later are missing from the catalog.
+*/
+class FStatCatalogCache
+{
+public:
+	// Returns false if the cache is missing, corrupted or was written by a different build.
+	static bool Load(TMap<FName, TArray<FName>>& OutStatGroups, TSet<FName>& OutModuleNames);
+
+	// Expects StatGroups to be sorted, so loading doesn't need to sort again.
+	static void Save(const TMap<FName, TArray<FName>>& StatGroups, const TSet<FName>& ModuleNames);
+
+	static void GetLoadedModuleNames(TSet<FName>& OutModuleNames);
+
+private:
+	static FString GetCacheFilePath();
+	// computed once per session, scanning the binaries is too slow to repeat on every load/save
+	static uint64 GetBuildKey();
+	static uint64 ComputeBuildKey();
+};
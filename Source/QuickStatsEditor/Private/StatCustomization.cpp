@@ -1,6 +1,7 @@
 // Copyright 2023 Amit Kumar Mehar. All Rights Reserved.
 
 #include "StatCustomization.h"
+#include "StatCatalogCache.h"
 
 #include "Runtime/Launch/Resources/Version.h"
 #include "IDetailChildrenBuilder.h"
@@ -22,6 +23,9 @@ TMap<FName, TArray<FName>>                                        FCodeStatDefin
 TArray<FCodeStatDefinitionCustomization::FTreeNodePtr>            FCodeStatDefinitionCustomization::AvailableStatGroupNodes;
 TArray<TArray<FCodeStatDefinitionCustomization::FTreeNodePtr>>    FCodeStatDefinitionCustomization::AvailableChildrenNodes;
 TArray<FCodeStatDefinitionCustomization::FTreeNodePtr>            FCodeStatDefinitionCustomization::AvailableStatNodes;
+FStatSearchIndex                                                  FCodeStatDefinitionCustomization::StatSearchIndex;
+uint32                                                            FCodeStatDefinitionCustomization::CatalogGeneration = 0;
+TSet<FName>                                                       FCodeStatDefinitionCustomization::CatalogModuleNames;
 
 class FStatGroupCollector final : public FOutputDevice
 {
@@ -112,11 +116,6 @@ TSharedRef<IPropertyTypeCustomization> FCodeStatDefinitionCustomization::MakeIns
 
 FCodeStatDefinitionCustomization::FCodeStatDefinitionCustomization()
 {
-	if (AvailableStatGroups.Num() == 0)
-	{
-		RefreshAvailableStats();
-	}
-
 	if (GEditor)
 	{
 		GEditor->RegisterForUndo(this);
@@ -234,7 +233,12 @@ void FCodeStatDefinitionCustomization::RefreshDefinitionFromProperty()
 
 TSharedRef<SWidget> FCodeStatDefinitionCustomization::GetMenuContent()
 {
+	// stats are only needed once the picker is opened, modules loaded since the last time can add more
+	RefreshAvailableStats(false);
+
 	FilterStringTokens.Reset();
+	SearchResultTokens.Reset();
+	TreeCatalogGeneration = CatalogGeneration;
 
 	StatTreeWidget = SNew(STreeView<FTreeNodePtr>)
 	.TreeItemsSource(&AvailableStatGroupNodes)
@@ -262,23 +266,11 @@ TSharedRef<SWidget> FCodeStatDefinitionCustomization::GetMenuContent()
 	})
 	.OnGetChildren_Lambda([this](FTreeNodePtr Row, TArray<FTreeNodePtr>& OutChildren)
 	{
-		if (Row->IsStatGroupNode())
+		// nodes of an older catalog (refreshed by another picker) are replaced on the next refresh of this tree
+		if (Row->IsStatGroupNode() && TreeCatalogGeneration == CatalogGeneration)
 		{
-			if ((FilterStringTokens.Num() > 0) && !FilterNodeCheck(Row.Get()))
-			{
-				OutChildren.Reserve(AvailableChildrenNodes[Row->GetChildrenIndex()].Num());
-				for (const FTreeNodePtr& Child : AvailableChildrenNodes[Row->GetChildrenIndex()])
-				{
-					if (FilterNodeCheck(Child.Get()))
-					{
-						OutChildren.Add(Child);
-					}
-				}
-			}
-			else
-			{
-				OutChildren = AvailableChildrenNodes[Row->GetChildrenIndex()];
-			}
+			const TArray<FTreeNodePtr>* FilteredChildren = (FilterStringTokens.Num() > 0) ? FilteredChildrenNodes.Find(Row->GetChildrenIndex()) : nullptr;
+			OutChildren = FilteredChildren ? *FilteredChildren : AvailableChildrenNodes[Row->GetChildrenIndex()];
 		}
 	})
 	.SelectionMode(ESelectionMode::Single)
@@ -286,7 +278,11 @@ TSharedRef<SWidget> FCodeStatDefinitionCustomization::GetMenuContent()
 	{
 		if (SelectInfo == ESelectInfo::OnMouseClick)
 		{
-			if (SelectedItem->IsStatNode())
+			if (TreeCatalogGeneration != CatalogGeneration)
+			{
+				RefreshStatTree();
+			}
+			else if (SelectedItem.IsValid() && SelectedItem->IsStatNode())
 			{
 				FTreeNodePtr StatGroupNode = AvailableStatGroupNodes[SelectedItem->GetParentIndex()];
 
@@ -311,7 +307,11 @@ TSharedRef<SWidget> FCodeStatDefinitionCustomization::GetMenuContent()
 				SelectedItem = Selection[0];
 			}
 
-			if (SelectedItem.IsValid() && SelectedItem->IsStatNode())
+			if (TreeCatalogGeneration != CatalogGeneration)
+			{
+				RefreshStatTree();
+			}
+			else if (SelectedItem.IsValid() && SelectedItem->IsStatNode())
 			{
 				FTreeNodePtr StatGroupNode = AvailableStatGroupNodes[SelectedItem->GetParentIndex()];
 
@@ -362,8 +362,8 @@ TSharedRef<SWidget> FCodeStatDefinitionCustomization::GetMenuContent()
 					.Text(LOCTEXT("Refresh", "Refresh"))
 					.OnClicked_Lambda([this]()
 					{
-						RefreshAvailableStats();
-
+						// node indices change, previous results aren't narrowed down since the generation changed
+						RefreshAvailableStats(true);
 						RefreshStatTree();
 
 						return FReply::Handled();
@@ -443,32 +443,68 @@ void FCodeStatDefinitionCustomization::RefreshStatTree()
 {
 	if (FilterStringTokens.Num() == 0)
 	{
+		SearchResultTokens.Reset();
+		SearchResults.Reset();
+
 		StatTreeWidget->SetTreeItemsSource(&AvailableStatGroupNodes);
 	}
 	else
 	{
-		FilteredStatGroupNodes.Empty();
+		// results of an older catalog point at different entries
+		TArray<FStatSearchIndex::FSearchResult> NewSearchResults;
+		const bool bNarrowSearch = (TreeCatalogGeneration == CatalogGeneration) && FStatSearchIndex::IsNarrowingQuery(SearchResultTokens, FilterStringTokens);
+		StatSearchIndex.Search(FilterStringTokens, bNarrowSearch ? &SearchResults : nullptr, NewSearchResults);
+
+		SearchResultTokens = FilterStringTokens;
+		SearchResults = MoveTemp(NewSearchResults);
+
+		FilteredStatGroupNodes.Reset();
+		FilteredChildrenNodes.Reset();
 
-		for (const FTreeNodePtr& StatGroupNode : AvailableStatGroupNodes)
+		const int32 NumStatGroups = AvailableStatGroupNodes.Num();
+		TBitArray<> AddedStatGroups(false, NumStatGroups);
+		TBitArray<> MatchedStatGroups(false, NumStatGroups);
+
+		// results are ranked, so groups and children are added in order of match quality
+		for (const FStatSearchIndex::FSearchResult& SearchResult : SearchResults)
 		{
-			if (FilterChildrenCheck(StatGroupNode.Get()))
+			int32 StatGroupIndex = INDEX_NONE;
+			if (SearchResult.EntryIndex < NumStatGroups)
 			{
-				// if any child node passes the filter, expand group node.
-				FilteredStatGroupNodes.Add(StatGroupNode);
-				StatTreeWidget->SetItemExpansion(StatGroupNode, true);
+				StatGroupIndex = SearchResult.EntryIndex;
+				MatchedStatGroups[StatGroupIndex] = true;
 			}
 			else
 			{
-				if (FilterNodeCheck(StatGroupNode.Get()))
-				{
-					// add group node in collapsed state.
-					FilteredStatGroupNodes.Add(StatGroupNode);
-				}
-				StatTreeWidget->SetItemExpansion(StatGroupNode, false);
+				const FTreeNodePtr& StatNode = AvailableStatNodes[SearchResult.EntryIndex - NumStatGroups];
+				StatGroupIndex = StatNode->GetParentIndex();
+				FilteredChildrenNodes.FindOrAdd(StatGroupIndex).Add(StatNode);
+			}
+
+			if (!AddedStatGroups[StatGroupIndex])
+			{
+				AddedStatGroups[StatGroupIndex] = true;
+				FilteredStatGroupNodes.Add(AvailableStatGroupNodes[StatGroupIndex]);
 			}
 		}
+
+		for (const FTreeNodePtr& StatGroupNode : FilteredStatGroupNodes)
+		{
+			const int32 StatGroupIndex = StatGroupNode->GetChildrenIndex();
+
+			// if any child node passes the filter, expand group node.
+			StatTreeWidget->SetItemExpansion(StatGroupNode, FilteredChildrenNodes.Contains(StatGroupIndex));
+
+			// group node passing the filter shows all the children.
+			if (MatchedStatGroups[StatGroupIndex])
+			{
+				FilteredChildrenNodes.Remove(StatGroupIndex);
+			}
+		}
+
 		StatTreeWidget->SetTreeItemsSource(&FilteredStatGroupNodes);
 	}
+	TreeCatalogGeneration = CatalogGeneration;
 
 	StatTreeWidget->RequestTreeRefresh();
 
@@ -480,7 +516,7 @@ void FCodeStatDefinitionCustomization::RefreshStatTree()
 
 void FCodeStatDefinitionCustomization::OnFilterTextChanged(const FText& InFilterText)
 {
-	FString FilterString = InFilterText.ToString().TrimStartAndEnd();
+	FString FilterString = InFilterText.ToString().TrimStartAndEnd().ToLower();
 	if (FilterString.Len() > 0)
 	{
 		FilterString.ParseIntoArray(FilterStringTokens, TEXT(" "));
@@ -493,65 +529,88 @@ void FCodeStatDefinitionCustomization::OnFilterTextChanged(const FText& InFilter
 	RefreshStatTree();
 }
 
-bool FCodeStatDefinitionCustomization::FilterNodeCheck(const FStatTreeNode* Node) const
+void FCodeStatDefinitionCustomization::RefreshAvailableStats(bool bForceCollect)
 {
-	for (const FString& FilterString : FilterStringTokens)
+	TSet<FName> LoadedModuleNames;
+	FStatCatalogCache::GetLoadedModuleNames(LoadedModuleNames);
+
+	// catalog of this session is up to date until a module it didn't see is loaded
+	const bool bIsCatalogLoaded = AvailableStatGroups.Num() > 0;
+	if (!bForceCollect && bIsCatalogLoaded && CatalogModuleNames.Includes(LoadedModuleNames))
 	{
-		if (!Node->GetValueAsString().Contains(FilterString))
-		{
-			return false;
-		}
+		return;
 	}
-	return true;
-}
 
-bool FCodeStatDefinitionCustomization::FilterChildrenCheck(const FStatTreeNode* Node) const
-{
-	if (Node->IsStatGroupNode())
+	const bool bHasCatalog = !bForceCollect && (bIsCatalogLoaded || FStatCatalogCache::Load(AvailableStatGroups, CatalogModuleNames));
+	if (!bHasCatalog || !CatalogModuleNames.Includes(LoadedModuleNames))
 	{
-		for (const FTreeNodePtr& Child : AvailableChildrenNodes[Node->GetChildrenIndex()])
+		TMap<FName, TArray<FName>> CollectedStatGroups;
 		{
-			if (FilterNodeCheck(Child.Get()))
+			FStatGroupCollector Collector(CollectedStatGroups);
+		}
+
+		// stats of modules that aren't loaded in this session stay in the catalog
+		if (bHasCatalog)
+		{
+			for (const auto& Itr : AvailableStatGroups)
 			{
-				return true;
+				TArray<FName>& StatNames = CollectedStatGroups.FindOrAdd(Itr.Key);
+				const TSet<FName> CollectedStatNames(StatNames);
+				for (FName StatName : Itr.Value)
+				{
+					if (!CollectedStatNames.Contains(StatName))
+					{
+						StatNames.Add(StatName);
+					}
+				}
 			}
+			LoadedModuleNames.Append(CatalogModuleNames);
 		}
-	}
-	return false;
-}
 
-void FCodeStatDefinitionCustomization::RefreshAvailableStats()
-{
-	{
-		FStatGroupCollector Collector(AvailableStatGroups);
+		AvailableStatGroups = MoveTemp(CollectedStatGroups);
+		CatalogModuleNames = MoveTemp(LoadedModuleNames);
+
+		// keep the catalog in display order, cache stores it sorted as well
+		AvailableStatGroups.KeySort(FNameLexicalLess());
+
+		if (AvailableStatGroups.Num() > 0)
+		{
+			FStatCatalogCache::Save(AvailableStatGroups, CatalogModuleNames);
+		}
 	}
 
 	AvailableStatGroupNodes.Reset(AvailableStatGroups.Num());
 	AvailableChildrenNodes.SetNum(AvailableStatGroups.Num());
 	AvailableStatNodes.Reset();
 
-	int32 ChildIndex = 0;
-	for (auto& Itr : AvailableStatGroups)
-	{
-		AvailableStatGroupNodes.Add(FStatTreeNode::MakeStatGroupNode(Itr.Key, ChildIndex));
-		ChildIndex++;
-	}
-	AvailableStatGroupNodes.Sort([](const FTreeNodePtr& A, const FTreeNodePtr& B) { return A->GetStatGroupName().ToString() < B->GetStatGroupName().ToString(); });
-
-	ChildIndex = 0;
+	// catalog is already sorted, so group index and children index are the same
+	int32 StatGroupIndex = 0;
 	for (const auto& Itr : AvailableStatGroups)
 	{
-		int32 StatGroupIndex = AvailableStatGroupNodes.IndexOfByPredicate([StatGroupName=Itr.Key](const FTreeNodePtr& Node) { return StatGroupName == Node->GetStatGroupName(); });
-		check(StatGroupIndex != INDEX_NONE);
+		AvailableStatGroupNodes.Add(FStatTreeNode::MakeStatGroupNode(Itr.Key, StatGroupIndex));
 
-		AvailableChildrenNodes[ChildIndex].Reset(Itr.Value.Num());
+		TArray<FTreeNodePtr>& ChildrenNodes = AvailableChildrenNodes[StatGroupIndex];
+		ChildrenNodes.Reset(Itr.Value.Num());
 		for (FName StatName : Itr.Value)
 		{
-			AvailableChildrenNodes[ChildIndex].Add(FStatTreeNode::MakeStatNode(StatName, StatGroupIndex));
-			AvailableStatNodes.Add(AvailableChildrenNodes[ChildIndex].Last());
+			ChildrenNodes.Add(FStatTreeNode::MakeStatNode(StatName, StatGroupIndex));
+			AvailableStatNodes.Add(ChildrenNodes.Last());
 		}
-		ChildIndex += 1;
+		StatGroupIndex++;
+	}
+
+	// groups first so entry index maps directly to StatGroup index, followed by all the stats
+	StatSearchIndex.Reset();
+	for (const FTreeNodePtr& StatGroupNode : AvailableStatGroupNodes)
+	{
+		StatSearchIndex.AddEntry(StatGroupNode->GetValueAsString());
+	}
+	for (const FTreeNodePtr& StatNode : AvailableStatNodes)
+	{
+		StatSearchIndex.AddEntry(StatNode->GetValueAsString());
 	}
+
+	CatalogGeneration++;
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "Modules/ModuleManager.h"
 
 #include "QuickStatExpressions.h"
+#include "StatSearchIndex.h"
 
 #include "IPropertyTypeCustomization.h"
 #include "EditorUndoClient.h"
@@ -25,6 +26,7 @@ class FCodeStatDefinitionCustomization : public IPropertyTypeCustomization, publ
 			TSharedPtr<FStatTreeNode> Node = MakeShared<FStatTreeNode>();
 			Node->bIsStatGroupNode = true;
 			Node->StatGroupOrStatName = InStatGroupName;
+			Node->StatGroupOrStatNameString = InStatGroupName.ToString();
 			Node->ParentOrChildrenIndex = InChildrenIndex;
 			return Node;
 		}
@@ -33,6 +35,7 @@ class FCodeStatDefinitionCustomization : public IPropertyTypeCustomization, publ
 			TSharedPtr<FStatTreeNode> Node = MakeShared<FStatTreeNode>();
 			Node->bIsStatGroupNode = false;
 			Node->StatGroupOrStatName = InStatName;
+			Node->StatGroupOrStatNameString = InStatName.ToString();
 			Node->ParentOrChildrenIndex = InParentIndex;
 			return Node;
 		}
@@ -62,13 +65,15 @@ class FCodeStatDefinitionCustomization : public IPropertyTypeCustomization, publ
 			return ParentOrChildrenIndex;
 		}
 
-		FString GetValueAsString() const
+		const FString& GetValueAsString() const
 		{
-			return StatGroupOrStatName.ToString();
+			return StatGroupOrStatNameString;
 		}
 
 	private:
 		FName StatGroupOrStatName = NAME_None;
+		// cached to avoid converting FName for every row/search
+		FString StatGroupOrStatNameString;
 		int32 ParentOrChildrenIndex = INDEX_NONE;
 		bool bIsStatGroupNode = true;
 	};
@@ -107,10 +112,10 @@ private:
 	void RefreshStatTree();
 
 	void OnFilterTextChanged(const FText& InFilterText);
-	bool FilterNodeCheck(const FStatTreeNode* Node) const;
-	bool FilterChildrenCheck(const FStatTreeNode* Node) const;
 
-	static void RefreshAvailableStats();
+	// loads stats from the on-disk catalog cache unless bForceCollect is set, stats are collected again and merged
+	// when modules that weren't loaded while the catalog was collected are loaded now
+	static void RefreshAvailableStats(bool bForceCollect);
 
 private:
 	TSharedPtr<IPropertyHandle> StructPropertyHandle;
@@ -121,9 +126,18 @@ private:
 	TSharedPtr<SComboButton> StatTreeMenuWidget;
 	TSharedPtr<SSearchBox> StatFilterWidget;
 
+	// lower-case search tokens
 	TArray<FString> FilterStringTokens;
 
+	// results of the last search, used to narrow down the search as the query grows
+	TArray<FString> SearchResultTokens;
+	TArray<FStatSearchIndex::FSearchResult> SearchResults;
+	// catalog generation the tree and search results were built from, the catalog is shared and any picker can refresh it
+	uint32 TreeCatalogGeneration = 0;
+
 	TArray<FTreeNodePtr> FilteredStatGroupNodes;
+	// StatGroup index to filtered children, groups matching the filter show all children
+	TMap<int32, TArray<FTreeNodePtr>> FilteredChildrenNodes;
 
 	// StatGroupName to children Stats
 	static TMap<FName, TArray<FName>>   AvailableStatGroups;
@@ -133,4 +147,10 @@ private:
 	static TArray<TArray<FTreeNodePtr>> AvailableChildrenNodes;
 	// All Stat nodes, mostly used for searching nodes easily
 	static TArray<FTreeNodePtr>         AvailableStatNodes;
+	// Search index over StatGroup nodes followed by Stat nodes
+	static FStatSearchIndex             StatSearchIndex;
+	// Incremented whenever the catalog is rebuilt, node and entry indices of older generations are invalid
+	static uint32                       CatalogGeneration;
+	// Modules loaded while the stats of the catalog were collected
+	static TSet<FName>                  CatalogModuleNames;
 };
\ No newline at end of file
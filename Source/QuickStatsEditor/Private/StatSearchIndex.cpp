@@ -0,0 +1,214 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#include "StatSearchIndex.h"
+
+void FStatSearchIndex::Reset()
+{
+	LowerCaseNames.Reset();
+	Names.Reset();
+	NameStartOffsets.Reset();
+	TrigramPostings.Reset();
+}
+
+int32 FStatSearchIndex::AddEntry(const FString& Name)
+{
+	const int32 EntryIndex = LowerCaseNames.Add(Name.ToLower());
+	Names.Add(Name);
+	const FString& LowerCaseName = LowerCaseNames[EntryIndex];
+
+	int32 NameStartOffset = 0;
+	if (LowerCaseName.StartsWith(TEXT("statgroup_"), ESearchCase::CaseSensitive))
+	{
+		NameStartOffset = 10;
+	}
+	else if (LowerCaseName.StartsWith(TEXT("stat_"), ESearchCase::CaseSensitive))
+	{
+		NameStartOffset = 5;
+	}
+	NameStartOffsets.Add(NameStartOffset);
+
+	// entries are added in increasing order, so posting lists stay sorted
+	for (int32 CharIndex = 0; CharIndex + 3 <= LowerCaseName.Len(); ++CharIndex)
+	{
+		TArray<int32>& Postings = TrigramPostings.FindOrAdd(MakeTrigramKey(*LowerCaseName + CharIndex));
+		if (Postings.Num() == 0 || Postings.Last() != EntryIndex)
+		{
+			Postings.Add(EntryIndex);
+		}
+	}
+
+	return EntryIndex;
+}
+
+void FStatSearchIndex::Search(const TArray<FString>& LowerCaseTokens, const TArray<FSearchResult>* Candidates, TArray<FSearchResult>& OutResults) const
+{
+	OutResults.Reset();
+
+	if (Candidates)
+	{
+		for (const FSearchResult& Candidate : *Candidates)
+		{
+			// candidates of an index that was rebuilt since are dropped instead of read out of bounds
+			if (!LowerCaseNames.IsValidIndex(Candidate.EntryIndex))
+			{
+				continue;
+			}
+
+			int32 Score;
+			if (ScoreEntry(Candidate.EntryIndex, LowerCaseTokens, Score))
+			{
+				OutResults.Add(FSearchResult{ Candidate.EntryIndex, Score });
+			}
+		}
+	}
+	else
+	{
+		// every match has to contain all trigrams of all tokens, so the shortest posting list is enough to find candidates
+		const TArray<int32>* ShortestPostings = nullptr;
+		for (const FString& Token : LowerCaseTokens)
+		{
+			for (int32 CharIndex = 0; CharIndex + 3 <= Token.Len(); ++CharIndex)
+			{
+				const TArray<int32>* Postings = TrigramPostings.Find(MakeTrigramKey(*Token + CharIndex));
+				if (!Postings)
+				{
+					// no entry contains this trigram
+					return;
+				}
+
+				if (!ShortestPostings || Postings->Num() < ShortestPostings->Num())
+				{
+					ShortestPostings = Postings;
+				}
+			}
+		}
+
+		if (ShortestPostings)
+		{
+			for (int32 EntryIndex : *ShortestPostings)
+			{
+				int32 Score;
+				if (ScoreEntry(EntryIndex, LowerCaseTokens, Score))
+				{
+					OutResults.Add(FSearchResult{ EntryIndex, Score });
+				}
+			}
+		}
+		else
+		{
+			// tokens are too short for the trigram lookup
+			for (int32 EntryIndex = 0; EntryIndex < LowerCaseNames.Num(); ++EntryIndex)
+			{
+				int32 Score;
+				if (ScoreEntry(EntryIndex, LowerCaseTokens, Score))
+				{
+					OutResults.Add(FSearchResult{ EntryIndex, Score });
+				}
+			}
+		}
+	}
+
+	OutResults.Sort([](const FSearchResult& A, const FSearchResult& B)
+	{
+		return (A.Score != B.Score) ? (A.Score > B.Score) : (A.EntryIndex < B.EntryIndex);
+	});
+}
+
+bool FStatSearchIndex::IsNarrowingQuery(const TArray<FString>& OldTokens, const TArray<FString>& NewTokens)
+{
+	if (OldTokens.Num() == 0 || OldTokens.Num() > NewTokens.Num())
+	{
+		return false;
+	}
+
+	// any entry containing the new token also contains the old token
+	for (int32 TokenIndex = 0; TokenIndex < OldTokens.Num(); ++TokenIndex)
+	{
+		if (!NewTokens[TokenIndex].Contains(OldTokens[TokenIndex], ESearchCase::CaseSensitive))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64 FStatSearchIndex::MakeTrigramKey(const TCHAR* Chars)
+{
+	constexpr uint64 CharMask = 0x1FFFFF;
+	return ((uint64(Chars[0]) & CharMask) << 42) | ((uint64(Chars[1]) & CharMask) << 21) | (uint64(Chars[2]) & CharMask);
+}
+
+bool FStatSearchIndex::ScoreEntry(int32 EntryIndex, const TArray<FString>& LowerCaseTokens, int32& OutScore) const
+{
+	const FString& Name = LowerCaseNames[EntryIndex];
+
+	// shorter names are closer to the query
+	OutScore = -Name.Len();
+
+	for (const FString& Token : LowerCaseTokens)
+	{
+		// the first occurrence isn't necessarily the best one, e.g. "gpu" in "FrameGPU_GPUTime"
+		int32 BestScore = INDEX_NONE;
+		for (int32 MatchIndex = Name.Find(Token, ESearchCase::CaseSensitive); MatchIndex != INDEX_NONE;
+			MatchIndex = Name.Find(Token, ESearchCase::CaseSensitive, ESearchDir::FromStart, MatchIndex + 1))
+		{
+			BestScore = FMath::Max(BestScore, ScoreMatch(EntryIndex, MatchIndex, Token.Len()));
+			if (BestScore >= 1000)
+			{
+				break;
+			}
+		}
+
+		if (BestScore == INDEX_NONE)
+		{
+			return false;
+		}
+		OutScore += BestScore;
+	}
+
+	return true;
+}
+
+int32 FStatSearchIndex::ScoreMatch(int32 EntryIndex, int32 MatchIndex, int32 MatchLen) const
+{
+	const int32 NameStart = NameStartOffsets[EntryIndex];
+
+	if ((MatchIndex == NameStart || MatchIndex == 0) && (MatchIndex + MatchLen == LowerCaseNames[EntryIndex].Len()))
+	{
+		// exact match (ignoring STAT_ prefix)
+		return 1000;
+	}
+	else if (MatchIndex == NameStart || MatchIndex == 0)
+	{
+		return 500;
+	}
+	else if (IsWordStart(EntryIndex, MatchIndex))
+	{
+		// match at word boundary
+		return 250;
+	}
+	return 100;
+}
+
+bool FStatSearchIndex::IsWordStart(int32 EntryIndex, int32 CharIndex) const
+{
+	const FString& Name = Names[EntryIndex];
+	if (CharIndex == 0)
+	{
+		return true;
+	}
+
+	const TCHAR Char = Name[CharIndex];
+	const TCHAR PrevChar = Name[CharIndex - 1];
+	if (!FChar::IsAlnum(PrevChar))
+	{
+		// '_', '.', ' ' separated
+		return FChar::IsAlnum(Char);
+	}
+	if (FChar::IsUpper(Char))
+	{
+		// "FrameGPU" starts at G, "GPUTime" starts at T
+		return FChar::IsLower(PrevChar) || (CharIndex + 1 < Name.Len() && FChar::IsLower(Name[CharIndex + 1]));
+	}
+	return false;
+}
@@ -0,0 +1,58 @@
+// Copyright 2023-2024 Amit Kumar Mehar. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Trigram index over stat and stat group names used by the stat picker.
+* Names are lower-cased once when added, queries use the smallest trigram posting list to find candidates
+* and rank the entries matching all tokens by match quality.
+*/
+class FStatSearchIndex
+{
+public:
+	struct FSearchResult
+	{
+		int32 EntryIndex = INDEX_NONE;
+		int32 Score = 0;
+	};
+
+	void Reset();
+
+	// Returns index of the added entry, entries are indexed in the order they are added.
+	int32 AddEntry(const FString& Name);
+
+	int32 Num() const { return LowerCaseNames.Num(); }
+
+	/*
+	* Finds entries containing all the tokens, tokens are expected to be lower-case.
+	* If Candidates is provided only those entries are considered, used to narrow down previous results when the query grows.
+	* Results are sorted by score (best match first).
+	*/
+	void Search(const TArray<FString>& LowerCaseTokens, const TArray<FSearchResult>* Candidates, TArray<FSearchResult>& OutResults) const;
+
+	// Returns true if NewTokens can only match a subset of entries matched by OldTokens.
+	static bool IsNarrowingQuery(const TArray<FString>& OldTokens, const TArray<FString>& NewTokens);
+
+private:
+	static uint64 MakeTrigramKey(const TCHAR* Chars);
+
+	// Returns false if any token is missing, otherwise OutScore is the combined match quality of all tokens.
+	bool ScoreEntry(int32 EntryIndex, const TArray<FString>& LowerCaseTokens, int32& OutScore) const;
+
+	// Match quality of a single token occurrence.
+	int32 ScoreMatch(int32 EntryIndex, int32 MatchIndex, int32 MatchLen) const;
+
+	// Start of a '_' separated or CamelCase word, needs the original case.
+	bool IsWordStart(int32 EntryIndex, int32 CharIndex) const;
+
+private:
+	TArray<FString> LowerCaseNames;
+	// Names as added, CamelCase word boundaries are lost when lower-casing
+	TArray<FString> Names;
+	// Offset where the name starts after STAT_/STATGROUP_ prefix, used to rank prefix matches
+	TArray<int32> NameStartOffsets;
+	// Trigram to sorted entry indices
+	TMap<uint64, TArray<int32>> TrigramPostings;
+};
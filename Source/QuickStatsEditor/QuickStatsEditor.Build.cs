@@ -18,6 +18,7 @@ public class QuickStatsEditor : ModuleRules
 				"InputCore",
 				"Engine",
 				"UnrealEd",
+				"Projects",
 				"QuickStats",
 			}
 		);